@@ -22,15 +22,47 @@
 #include <span>
 #include <ranges>
 #include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <format>
 #include <variant>
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <cstring>
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <memory>
 #include <memory_resource>
+#include <coroutine>
+#include <exception>
+#include <atomic>
+
+#if defined(__cpp_lib_mdspan)
+#include <mdspan>
+#endif
+
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))
+#include <nmmintrin.h>
+#endif
 
 #ifdef FOX_SERIALIZE_HAS_REFLEXPR
 #include <fox/reflexpr.hpp>
 #endif
 
+#ifdef FOX_SERIALIZE_INSTRUMENTATION
+#include <chrono>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
 #ifdef FOX_SERIALIZE_INLINE
 #pragma message "FOX_SERIALIZE_INLINE macro is internally used by redskittlefox/serialize library"
 #undef FOX_SERIALIZE_INLINE
@@ -61,213 +93,389 @@ namespace fox::serialize
 {
 #pragma region streams
 	class bit_writer;
+	class external_bit_writer;
 	class bit_reader;
 
 	/**
-	 * \brief Implements raw byte buffer that can be written to.
+	 * \brief Table of strings used for string deduplication. Refer to bit_writer::set_string_dictionary.
+	 * Strings are stored in a single arena, views returned by the dictionary are valid until it's cleared or destroyed.
 	 */
-	class bit_writer
+	class string_dictionary
 	{
-		std::pmr::vector<std::byte> buffer_;
+		std::pmr::monotonic_buffer_resource arena_;
+		std::pmr::vector<std::string_view> strings_;
+		std::pmr::unordered_map<std::string_view, std::size_t> ids_;
 
 	public:
 		/**
-		 * \brief Default constructor. Constructs empty bit_writer.
-		 */
-		bit_writer() = default;
-
-		/**
-		 * \brief Constructs an empty bit_writer with the given memory resource.
-		 * \param mr Memory resource to construct bit_writer with.
+		 * \brief Constructs an empty string_dictionary.
+		 * \param mr Memory resource the strings and lookup tables are allocated from.
 		 */
-		bit_writer(std::pmr::memory_resource* mr)
-			: buffer_(std::pmr::polymorphic_allocator{mr}) {}
+		explicit string_dictionary(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+			: arena_(mr), strings_(std::pmr::polymorphic_allocator{ mr }), ids_(std::pmr::polymorphic_allocator{ mr }) {}
 
-		/**
-		 * \brief Copy constructor. Constructs bit_writer with the copy of the contents of the other.
-		 */
-		bit_writer(const bit_writer&) = default;
+		string_dictionary(const string_dictionary&) = delete;
+		string_dictionary& operator=(const string_dictionary&) = delete;
 
+	public:
 		/**
-		 * \brief Move constructor. Constructs bit_writer with the contents of other using move semantics.
+		 * \brief Finds the id of the string.
+		 * \return Id of the string or std::nullopt if it's not in the dictionary.
 		 */
-		bit_writer(bit_writer&&) noexcept = default;
+		[[nodiscard]] std::optional<std::size_t> find(std::string_view str) const
+		{
+			if (const auto it = ids_.find(str); it != std::end(ids_))
+				return it->second;
 
-		/**
-		 * \brief Copy assignment operator. Replaces the contents with a copy of the contents of other.
-		 * \return *this
-		 */
-		bit_writer& operator=(const bit_writer&) = default;
+			return std::nullopt;
+		}
 
 		/**
-		 * \brief Move assignment operator. Replaces the contents with those of other using move semantics.
-		 * \return *this
+		 * \brief Copies the string into the dictionary and assigns it the next id.
+		 * \return View of the stored string.
 		 */
-		bit_writer& operator=(bit_writer&&) noexcept = default;
+		std::string_view insert(std::string_view str)
+		{
+			char* storage = std::empty(str) ? nullptr : static_cast<char*>(arena_.allocate(std::size(str), alignof(char)));
+			if (storage != nullptr)
+				(void)std::memcpy(storage, std::data(str), std::size(str));
 
-		/**
-		 * \brief Destructor of the bit_writer.
-		 */
-		~bit_writer() noexcept = default;
+			const std::string_view stored(storage, std::size(str));
+			ids_.emplace(stored, std::size(strings_));
+			strings_.push_back(stored);
+			return stored;
+		}
 
-	public:
 		/**
-		 * \brief Returns the allocator associated with the bit_writer.
-		 * \return The associated allocator.
+		 * \brief Returns the string with the given id.
+		 * \throws std::invalid_argument if there is no string with the given id.
 		 */
-		auto get_allocator() const noexcept -> decltype(buffer_)::allocator_type
+		[[nodiscard]] std::string_view at(std::size_t id) const
 		{
-			return buffer_.get_allocator();
+			if (id >= std::size(strings_))
+				throw std::invalid_argument("Invalid string dictionary id.");
+
+			return strings_[id];
 		}
 
-	public:
 		/**
-		 * \brief Erases previously serialized data. Resets bit_writer.
+		 * \brief Number of strings in the dictionary.
 		 */
-		void clear()
+		[[nodiscard]] std::size_t size() const noexcept
 		{
-			buffer_.clear();
+			return std::size(strings_);
 		}
 
-	public:
 		/**
-		 * \brief Allocates memory to write num_bytes in the bit_writer.
-		 * \param num_bytes Number of bytes requested to be written.
-		 * \return Pointer to memory, to populate with serialized data. Returned pointer is invalidated on the next call to write_bytes.
+		 * \brief Removes strings with ids not lower than the given size. Their storage is released by clear().
+		 * \param size Number of strings to keep.
 		 */
-		[[nodiscard]] FOX_SERIALIZE_INLINE void* write_bytes(std::size_t num_bytes)
+		void truncate(std::size_t size)
 		{
-			const std::size_t offset = std::size(buffer_);
-			buffer_.resize(offset + num_bytes);
-			return static_cast<void*>(std::data(buffer_) + offset);
+			for (std::size_t id = size; id < std::size(strings_); ++id)
+			{
+				if (const auto it = ids_.find(strings_[id]); it != std::end(ids_) && it->second == id)
+					ids_.erase(it);
+			}
+
+			if (size < std::size(strings_))
+				strings_.resize(size);
 		}
 
 		/**
-		 * \brief Allocates memory to write NumBytes in the bit_writer.
-		 * \tparam NumBytes Number of bytes requested to be written.
-		 * \return Pointer to memory, to populate with serialized data. Returned pointer is invalidated on the next call to write_bytes.
+		 * \brief Removes all strings and releases their storage.
 		 */
-		template<std::size_t NumBytes>
-		[[nodiscard]] FOX_SERIALIZE_INLINE void* write_bytes()
+		void clear() noexcept
 		{
-			const std::size_t offset = std::size(buffer_);
-			buffer_.resize(offset + NumBytes);
-			return static_cast<void*>(std::data(buffer_) + offset);
+			ids_.clear();
+			strings_.clear();
+			arena_.release();
 		}
+	};
+
+	namespace details
+	{
+		// Unique address per type, used to validate references to shared objects
+		template<class T>
+		struct object_type_tag
+		{
+			static constexpr char value{};
+		};
+
+		struct object_key
+		{
+			const void* address;
+			const void* type;
+
+			friend bool operator==(const object_key&, const object_key&) = default;
+		};
+
+		struct object_key_hash
+		{
+			std::size_t operator()(const object_key& key) const noexcept
+			{
+				const std::size_t a = std::hash<const void*>{}(key.address);
+				return a ^ (std::hash<const void*>{}(key.type) + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+			}
+		};
+
+		// Objects written through std::shared_ptr, kept alive so their addresses can't be reused while the ids are in use
+		struct writer_object_table
+		{
+			std::unordered_map<object_key, std::size_t, object_key_hash> ids;
+			std::vector<std::shared_ptr<const void>> objects;
+		};
+
+		// Objects read through std::shared_ptr, indexed by their id
+		struct reader_object_table
+		{
+			struct entry
+			{
+				std::shared_ptr<void> object;
+				const void* type;
+			};
+
+			std::vector<entry> objects;
+		};
+	}
+
+	/**
+	 * \brief Tag type used to construct bit_writer that only counts written bytes.
+	 */
+	struct counting_writer_t {};
+
+	/**
+	 * \brief Tag used to construct bit_writer that only counts written bytes.
+	 */
+	constexpr counting_writer_t counting_writer;
+
+	/**
+	 * \brief Exception thrown when bit_writer over the caller provided storage runs out of space.
+	 */
+	class buffer_overflow : public std::length_error
+	{
+		std::size_t required_;
 
 	public:
 		/**
-		 * \brief Direct access to the underlying contiguous storage.
-		 * \return Span of bytes to serialized data.
+		 * \brief Constructs buffer_overflow exception.
+		 * \param required Number of bytes the storage would have to hold to complete the write.
 		 */
-		[[nodiscard]] std::span<const std::byte> data() const noexcept
+		explicit buffer_overflow(std::size_t required)
+			: std::length_error("Serialized data doesn't fit into the storage."), required_(required) {}
+
+		/**
+		 * \brief Number of bytes the storage would have to hold to complete the write that failed.
+		 */
+		[[nodiscard]] std::size_t required() const noexcept
 		{
-			return buffer_;
+			return required_;
 		}
 	};
 
 	/**
-	 * \brief Tag type used for the constructor disambiguation.
-	 * Refer to samples/sample_custom_3.cpp
+	 * \brief Behaviour of bit_writer over the caller provided storage, when the data doesn't fit into it.
 	 */
-	struct from_bit_reader_t {};
+	enum class overflow_policy : std::uint8_t
+	{
+		// Throws buffer_overflow
+		throw_exception,
+		// Stops storing data and only counts written bytes, refer to bit_writer::overflowed
+		report
+	};
 
 	/**
-	 * \brief Tag used for the constructor disambiguation.
-	 * Refer to samples/sample_custom_3.cpp
+	 * \brief Function called when bit_writer over the caller provided storage runs out of space.
+	 * \param context Pointer passed to external_bit_writer constructor.
+	 * \param filled Data written to the current storage, it's not accessed by the bit_writer anymore.
+	 * \param required Minimal size of the returned storage.
+	 * \return New storage to continue writing to. Storage smaller than required results in buffer_overflow.
 	 */
-	constexpr from_bit_reader_t from_bit_reader;
+	using spill_function = std::span<std::byte>(*)(void* context, std::span<const std::byte> filled, std::size_t required);
 
 	/**
-	 * \brief Implements raw byte buffer that can be read from.
+	 * \brief Storage that bit_writer grows in place, the written data stays contiguous, e.g. memory that can be remapped.
 	 */
-	class bit_reader
+	class growable_storage
+	{
+	public:
+		virtual ~growable_storage() = default;
+
+		/**
+		 * \brief Current storage.
+		 */
+		[[nodiscard]] virtual std::span<std::byte> storage() noexcept = 0;
+
+		/**
+		 * \brief Grows the storage, keeping its contents.
+		 * \param required Minimal size of the returned storage.
+		 * \return Storage of at least required bytes starting with the contents of the current one.
+		 */
+		[[nodiscard]] virtual std::span<std::byte> grow(std::size_t required) = 0;
+
+		/**
+		 * \brief Called when bit_writer is cleared, the storage can release memory while keeping its capacity.
+		 * \param used Number of bytes that were written to the storage.
+		 */
+		virtual void release([[maybe_unused]] std::size_t used) noexcept {}
+	};
+
+	/**
+	 * \brief Implements raw byte buffer that can be written to.
+	 */
+	class bit_writer
 	{
+		enum class mode : std::uint8_t
+		{
+			owned,
+			counting,
+			external
+		};
+
+		// Storage provided by the caller, written bytes are counted by counted_
+		struct external_storage
+		{
+			std::byte* data = nullptr;
+			std::size_t capacity = 0;
+			std::size_t spilled = 0;
+			spill_function spill = nullptr;
+			void* context = nullptr;
+			growable_storage* growable = nullptr;
+			overflow_policy policy = overflow_policy::throw_exception;
+			bool overflowed = false;
+		};
+
 		std::pmr::vector<std::byte> buffer_;
-		std::size_t offset_{};
+
+		// Counting writer keeps the number of written bytes, written data goes to the scratch space
+		static constexpr std::size_t counting_scratch_size = 256;
+		std::size_t counted_{};
+		mode mode_ = mode::owned;
+		external_storage external_;
+		string_dictionary* strings_ = nullptr;
+		std::unique_ptr<details::writer_object_table> objects_;
+		std::size_t alignment_{};
+
 	public:
 		/**
-		 * \brief Default constructor. Constructs empty bit_reader.
+		 * \brief Default constructor. Constructs empty bit_writer.
 		 */
-		bit_reader() = default;
+		bit_writer() = default;
 
 		/**
-		 * \brief Constructs an empty bit_reader with the given memory resource.
-		 * \param mr Memory resource to construct bit_reader with.
+		 * \brief Constructs bit_writer that doesn't store written data, it only counts written bytes.
 		 */
-		bit_reader(std::pmr::memory_resource* mr)
-			: buffer_(std::pmr::polymorphic_allocator{ mr }), offset_(static_cast<std::size_t>(0)) {}
+		explicit bit_writer(counting_writer_t)
+			: mode_(mode::counting) {}
 
 		/**
-		 * \brief Copy constructor. Constructs bit_reader with the copy of the contents of the other.
-		 * \param other bit_reader to copy contents from
+		 * \brief Constructs an empty bit_writer with the given memory resource.
+		 * \param mr Memory resource to construct bit_writer with.
 		 */
-		bit_reader(const bit_reader& other) : buffer_(other.buffer_), offset_(other.offset_) {}
+		bit_writer(std::pmr::memory_resource* mr)
+			: buffer_(std::pmr::polymorphic_allocator{mr}) {}
 
 		/**
-		 * \brief Move constructor. Constructs bit_reader with the contents of other using move semantics.
-		 * \param other bit_reader to move contents from
+		 * \brief Copy constructor. Constructs bit_writer with the copy of the contents of the other.
+		 * \throws std::logic_error if other writes into the caller provided storage, e.g. external_bit_writer referred to as bit_writer.
 		 */
-		bit_reader(bit_reader&& other) noexcept
-			: buffer_(std::exchange(other.buffer_, {})), offset_(std::exchange(other.offset_, {}))
-		{}
+		bit_writer(const bit_writer& other)
+			: buffer_(other.buffer_), counted_(other.counted_), mode_(copyable_mode(other)), external_(other.external_), strings_(other.strings_),
+			objects_(other.objects_ ? std::make_unique<details::writer_object_table>(*other.objects_) : nullptr), alignment_(other.alignment_) {}
+
+		/**
+		 * \brief Move constructor. Constructs bit_writer with the contents of other using move semantics.
+		 * Other is left empty, it no longer refers to the caller provided storage.
+		 */
+		bit_writer(bit_writer&& other) noexcept
+			: buffer_(std::move(other.buffer_)), counted_(std::exchange(other.counted_, 0)), mode_(std::exchange(other.mode_, mode::owned)),
+			external_(std::exchange(other.external_, {})), strings_(other.strings_), objects_(std::move(other.objects_)),
+			alignment_(std::exchange(other.alignment_, 0)) {}
+
+		/**
+		 * \brief external_bit_writer is move-only, so two writers never write into the same storage.
+		 */
+		bit_writer(const external_bit_writer&) = delete;
 
 		/**
 		 * \brief Copy assignment operator. Replaces the contents with a copy of the contents of other.
-		 * \param other bit_reader to copy contents from
+		 * \throws std::logic_error if other writes into the caller provided storage, e.g. external_bit_writer referred to as bit_writer.
 		 * \return *this
 		 */
-		bit_reader& operator=(const bit_reader& other)
+		bit_writer& operator=(const bit_writer& other)
 		{
-			buffer_ = other.buffer_;
-			offset_ = other.offset_;
+			if (this != std::addressof(other))
+			{
+				mode_ = copyable_mode(other);
+				buffer_ = other.buffer_;
+				counted_ = other.counted_;
+				external_ = other.external_;
+				strings_ = other.strings_;
+				objects_ = other.objects_ ? std::make_unique<details::writer_object_table>(*other.objects_) : nullptr;
+				alignment_ = other.alignment_;
+			}
 			return *this;
 		}
 
+		/**
+		 * \brief external_bit_writer is move-only, so two writers never write into the same storage.
+		 */
+		bit_writer& operator=(const external_bit_writer&) = delete;
+
 		/**
 		 * \brief Move assignment operator. Replaces the contents with those of other using move semantics.
-		 * \param other bit_reader to move contents from
+		 * Other is left empty, it no longer refers to the caller provided storage.
 		 * \return *this
 		 */
-		bit_reader& operator=(bit_reader&& other) noexcept
+		bit_writer& operator=(bit_writer&& other) noexcept
 		{
-			buffer_ = std::exchange(other.buffer_, {});
-			offset_ = std::exchange(other.offset_, {});
+			if (this != std::addressof(other))
+			{
+				buffer_ = std::move(other.buffer_);
+				other.buffer_.clear();
+				counted_ = std::exchange(other.counted_, 0);
+				mode_ = std::exchange(other.mode_, mode::owned);
+				external_ = std::exchange(other.external_, {});
+				strings_ = other.strings_;
+				objects_ = std::move(other.objects_);
+				alignment_ = std::exchange(other.alignment_, 0);
+			}
 			return *this;
 		}
 
 		/**
-		 * \brief Constructs bit_reader with the contents of the range.
-		 * \tparam Range Range of trivial types convertible to the range of bytes.
-		 * \param range Range of trivial types convertible to the range of bytes.
+		 * \brief Destructor of the bit_writer.
 		 */
-		template<std::ranges::range Range>
-		bit_reader(std::from_range_t, Range && range)
-			requires std::is_trivial_v<std::ranges::range_value_t<Range>>
-		{
-			using value_type = std::ranges::range_value_t<Range>;
-			if constexpr (std::ranges::contiguous_range<Range>)
-			{
-				auto span = std::as_bytes(std::span(range));
-				buffer_ = span | std::ranges::to<std::pmr::vector<std::byte>>();
-			}
-			else
-			{
-				auto it = std::begin(range);
-				auto end = std::end(range);
-				buffer_ = std::ranges::subrange(it, end)
-					| std::transform(
-					[](const value_type& v) -> std::array<std::byte, sizeof(value_type)>
-					{ return std::bit_cast<std::array<std::byte, sizeof(value_type)>>(v); })
-					| std::views::join
-					| std::ranges::to<std::vector<std::byte>>();
-			}
-		}
+		~bit_writer() noexcept = default;
 
+	protected:
 		/**
-		 * \brief Destructor of the bit_reader.
+		 * \brief Constructs bit_writer writing into the caller provided storage, it never allocates memory for the written data.
+		 * Storage has to outlive the bit_writer.
+		 * \param storage Storage to write to.
+		 * \param policy Behaviour when the data doesn't fit into the storage.
 		 */
-		~bit_reader() noexcept = default;
+		explicit bit_writer(std::span<std::byte> storage, overflow_policy policy = overflow_policy::throw_exception)
+			: mode_(mode::external), external_{ .data = std::data(storage), .capacity = std::size(storage), .policy = policy } {}
+
+		/**
+		 * \brief Constructs bit_writer writing into the caller provided storage, spilling full storage to the callback.
+		 * Storage has to outlive the bit_writer.
+		 * \param storage Storage to write to.
+		 * \param spill Function called with the filled storage when the next write doesn't fit into it, returns the storage to continue with.
+		 * \param context Pointer passed to spill.
+		 */
+		bit_writer(std::span<std::byte> storage, spill_function spill, void* context = nullptr)
+			: mode_(mode::external), external_{ .data = std::data(storage), .capacity = std::size(storage), .spill = spill, .context = context } {}
+
+		/**
+		 * \brief Constructs bit_writer writing into the growable storage, e.g. page_storage. Written data stays contiguous,
+		 * the storage grows in place instead of copying the data into a larger buffer.
+		 * Storage has to outlive the bit_writer.
+		 * \param storage Storage to write to.
+		 */
+		explicit bit_writer(growable_storage& storage)
+			: mode_(mode::external), external_{ .data = std::data(storage.storage()), .capacity = std::size(storage.storage()), .growable = &storage } {}
 
 	public:
 		/**
@@ -281,775 +489,6507 @@ namespace fox::serialize
 
 	public:
 		/**
-		 * \brief Erases previously serialized data. Resets bit_writer.
+		 * \brief Enables string deduplication. Strings already present in the dictionary are written as references.
+		 * Data has to be read by bit_reader with the dictionary containing the same strings, e.g. a new one for both.
+		 * \param dictionary Dictionary to use, nullptr disables deduplication.
 		 */
-		void clear()
+		void set_string_dictionary(string_dictionary* dictionary) noexcept
 		{
-			buffer_.clear();
-			offset_ = {};
+			strings_ = dictionary;
+		}
+
+		/**
+		 * \brief Returns the string dictionary, nullptr if string deduplication is disabled.
+		 */
+		[[nodiscard]] string_dictionary* get_string_dictionary() const noexcept
+		{
+			return strings_;
 		}
+
 	public:
 		/**
-		 * \brief Acquires pointer to the data that is to be deserialized.
-		 * \param num_bytes Number of bytes requested to be read.
-		 * \return Pointer to memory, that contains serialized object.
+		 * \brief Enables the aligned layout. Elements of ranges of trivially copyable types are padded to a multiple of
+		 * std::max(alignment, alignof(T)) bytes from the start of the data, so they can be accessed in place, refer to read_span.
+		 * Data has to be read by bit_reader with the same alignment.
+		 * \param alignment Power of two, 1 aligns to alignof(T), 0 disables padding.
+		 * \throws std::invalid_argument if the alignment isn't a power of two or 0
 		 */
-		[[nodiscard]] FOX_SERIALIZE_INLINE const void* read_bytes(std::size_t num_bytes)
+		void set_alignment(std::size_t alignment)
 		{
-			if (offset_ + num_bytes > std::size(buffer_))
-				throw std::out_of_range("Trying to serialize data that is out of range.");
+			if (alignment != 0 && !std::has_single_bit(alignment))
+				throw std::invalid_argument("Alignment has to be a power of two.");
 
-			const void* ptr = static_cast<const void*>(std::data(buffer_) + offset_);
-			offset_ += num_bytes;
-			return ptr;
+			alignment_ = alignment;
 		}
 
 		/**
-		 * \brief Acquires pointer to the data that is to be deserialized.
-		 * \tparam NumBytes Number of bytes requested to be read.
-		 * \return Pointer to memory, that contains serialized object.
+		 * \brief Returns the alignment of the aligned layout, 0 if it's disabled.
 		 */
-		template<std::size_t NumBytes>
-		[[nodiscard]] FOX_SERIALIZE_INLINE const void* read_bytes()
+		[[nodiscard]] std::size_t alignment() const noexcept
 		{
-			if (offset_ + NumBytes > std::size(buffer_))
-				throw std::out_of_range("Trying to serialize data that is out of range.");
+			return alignment_;
+		}
 
-			const void* ptr = static_cast<const void*>(std::data(buffer_) + offset_);
-			offset_ += NumBytes;
-			return ptr;
+		/**
+		 * \brief Writes zero bytes until the size is a multiple of the alignment.
+		 * \param alignment Power of two.
+		 */
+		void align(std::size_t alignment)
+		{
+			if (const std::size_t padding = (alignment - size() % alignment) % alignment; padding != 0)
+				(void)std::memset(write_bytes(padding), 0, padding);
 		}
-	};
 
-#pragma endregion streams
+	public:
+		/**
+		 * \brief Returns the table of objects written through std::shared_ptr. Released by clear().
+		 */
+		[[nodiscard]] details::writer_object_table& object_table()
+		{
+			if (!objects_)
+				objects_ = std::make_unique<details::writer_object_table>();
 
-#pragma region traits
-	/**
-	 * \brief Trait class used to provide serialization methods for a given type.
-	 * \tparam T Serialized type.
-	 */
-	template<class T> struct serialize_traits;
-
-	namespace details
-	{
-		// Internal serialization trait, selected if no public serialize_traits is available
-		template<class T> struct builtin_serialize_traits;
+			return *objects_;
+		}
 
-		template<class T>
-		concept builtin_serializable = requires (bit_writer & writer, const T & a)
+	public:
+		/**
+		 * \brief Erases previously serialized data. Resets bit_writer.
+		 */
+		void clear()
 		{
-			{ ::fox::serialize::details::builtin_serialize_traits<T>::serialize(writer, a)		} -> std::same_as<void>;
-		};
+			if (external_.growable != nullptr)
+				external_.growable->release(counted_);
 
-		template<class T>
-		concept builtin_deserializable = requires (bit_reader & reader, T & b)
+			buffer_.clear();
+			counted_ = {};
+			objects_.reset();
+
+			if (external_.overflowed)
+				mode_ = mode::external;
+
+			external_.spilled = {};
+			external_.overflowed = false;
+		}
+
+		/**
+		 * \brief Reserves storage for at least new_capacity bytes of serialized data. Has no effect on the caller provided storage,
+		 * unless it's growable.
+		 * \param new_capacity Number of bytes to reserve.
+		 */
+		void reserve(std::size_t new_capacity)
 		{
-			{ ::fox::serialize::details::builtin_serialize_traits<T>::deserialize(reader, b)	} -> std::same_as<void>;
-		};
+			if (mode_ != mode::external)
+				buffer_.reserve(new_capacity);
+			else if (external_.growable != nullptr && new_capacity > external_.capacity)
+				grow_external(new_capacity);
+		}
 
-		template<class T>
-		concept custom_serializable_serialize_trait = requires (bit_writer & writer, const T & a)
+		/**
+		 * \brief Returns the number of bytes that can be written without reallocation.
+		 * \return Capacity of the underlying storage.
+		 */
+		[[nodiscard]] std::size_t capacity() const noexcept
 		{
-			serialize_traits<T>::serialize(writer, a);
-		};
+			return mode_ == mode::external ? external_.capacity : buffer_.capacity();
+		}
 
-		template<class T>
-		concept custom_serializable_member_function = requires (bit_writer & writer, const T & a)
+		/**
+		 * \brief Requests the removal of unused capacity.
+		 */
+		void shrink_to_fit()
 		{
-			a.serialize(writer);
-		};
+			buffer_.shrink_to_fit();
+		}
 
-		template<class T>
-		concept custom_serializable_static_member_function = requires (bit_writer & writer, const T & a)
+	public:
+		/**
+		 * \brief Allocates memory to write num_bytes in the bit_writer.
+		 * \param num_bytes Number of bytes requested to be written.
+		 * \return Pointer to memory, to populate with serialized data. Returned pointer is invalidated on the next call to write_bytes.
+		 */
+		[[nodiscard]] FOX_SERIALIZE_INLINE void* write_bytes(std::size_t num_bytes)
 		{
-			T::serialize(writer, a);
-		};
+			if (mode_ != mode::owned) [[unlikely]]
+				return write_unowned(num_bytes);
 
-		template<class T>
-		concept custom_serializable_member_serialize_trait = requires (bit_writer & writer, const T & a)
+			const std::size_t offset = std::size(buffer_);
+			buffer_.resize(offset + num_bytes);
+			return static_cast<void*>(std::data(buffer_) + offset);
+		}
+
+		/**
+		 * \brief Writes num_bytes copied from bytes. The counting bit_writer only counts them, use it for large writes.
+		 * \param bytes Bytes to write.
+		 * \param num_bytes Number of bytes to write.
+		 */
+		FOX_SERIALIZE_INLINE void write_bytes(const void* bytes, std::size_t num_bytes)
 		{
-			T::serialize_trait::serialize(writer, a);
-		};
+			if (mode_ != mode::owned) [[unlikely]]
+				return write_unowned(bytes, num_bytes);
 
-		template<class T>
-		concept custom_serializable =
-			custom_serializable_serialize_trait<T> ||
-			custom_serializable_member_function<T> ||
-			custom_serializable_static_member_function<T> ||
-			custom_serializable_member_serialize_trait<T>;
+			const std::size_t offset = std::size(buffer_);
+			buffer_.resize(offset + num_bytes);
+			if (num_bytes != 0)
+				(void)std::memcpy(std::data(buffer_) + offset, bytes, num_bytes);
+		}
 
-		template<class T>
-		concept custom_deserializable_serializable_trait = requires (bit_reader & reader, T & b)
+		/**
+		 * \brief Allocates memory to write NumBytes in the bit_writer.
+		 * \tparam NumBytes Number of bytes requested to be written.
+		 * \return Pointer to memory, to populate with serialized data. Returned pointer is invalidated on the next call to write_bytes.
+		 */
+		template<std::size_t NumBytes>
+		[[nodiscard]] FOX_SERIALIZE_INLINE void* write_bytes()
 		{
-			serialize_traits<T>::deserialize(reader, b);
-		};
+			if (mode_ != mode::owned) [[unlikely]]
+				return write_unowned(NumBytes);
 
-		template<class T>
-		concept custom_deserializable_member_function = requires (bit_reader & reader, T& a)
+			const std::size_t offset = std::size(buffer_);
+			buffer_.resize(offset + NumBytes);
+			return static_cast<void*>(std::data(buffer_) + offset);
+		}
+
+	public:
+		/**
+		 * \brief Direct access to the underlying contiguous storage.
+		 * \return Span of bytes to serialized data. For the caller provided storage only the data that wasn't spilled yet.
+		 */
+		[[nodiscard]] std::span<const std::byte> data() const noexcept
 		{
-			a.deserialize(reader);
-		};
+			if (mode_ == mode::external)
+				return { external_.data, counted_ };
 
-		template<class T>
-		concept custom_deserializable_static_member_function = requires (bit_reader & reader, T& a)
+			if (mode_ == mode::counting)
+				return {};
+
+			return buffer_;
+		}
+
+		/**
+		 * \brief Returns the number of bytes written, including spilled data.
+		 */
+		[[nodiscard]] std::size_t size() const noexcept
 		{
-			T::deserialize(reader, a);
-		};
+			if (mode_ == mode::external)
+				return external_.spilled + counted_;
 
-		template<class T>
-		concept custom_deserializable_member_serialize_trait = requires (bit_reader & reader, T& a)
+			return mode_ == mode::counting ? counted_ : std::size(buffer_);
+		}
+
+		/**
+		 * \brief Writes num_bytes to be overwritten later with patch, e.g. a length known only after writing the data following it.
+		 * \param num_bytes Number of bytes to reserve.
+		 * \return Position of the reserved bytes.
+		 */
+		[[nodiscard]] std::size_t write_placeholder(std::size_t num_bytes)
 		{
-			T::serialize_trait::deserialize(reader, a);
-		};
+			const std::size_t position = size();
+			(void)std::memset(write_bytes(num_bytes), 0, num_bytes);
+			return position;
+		}
 
-		template<class T>
-		concept custom_deserializable_construct = requires (bit_reader & reader, T & a)
+		/**
+		 * \brief Overwrites previously written bytes. Has no effect on the counting bit_writer.
+		 * \param position Position of the bytes, e.g. returned by write_placeholder.
+		 * \param bytes Bytes to write.
+		 * \param num_bytes Number of bytes to write.
+		 * \throws std::out_of_range if the bytes weren't written yet or were already passed to the spill function.
+		 */
+		void patch(std::size_t position, const void* bytes, std::size_t num_bytes)
 		{
-			a = T(from_bit_reader, reader);
-		};
+			if (mode_ == mode::counting)
+				return;
 
-		template<class T>
-		concept custom_deserializable =
-			custom_deserializable_serializable_trait<T> ||
-			custom_deserializable_member_function<T> ||
-			custom_deserializable_static_member_function<T> ||
-			custom_deserializable_member_serialize_trait<T> ||
-			custom_deserializable_construct<T>;
-	}
+			std::byte* data = std::data(buffer_);
+			std::size_t written = std::size(buffer_);
+			if (mode_ == mode::external)
+			{
+				if (position < external_.spilled)
+					throw std::out_of_range("Trying to patch data that was already spilled.");
 
-	/**
-	 * \brief Check, if type is serializable.
-	 * \tparam T a type to check
-	 */
-	template<class T>
-	concept serializable = ::fox::serialize::details::builtin_serializable<T> || ::fox::serialize::details::custom_serializable<T>;
+				position -= external_.spilled;
+				data = external_.data;
+				written = counted_;
+			}
 
-	/**
-	 * \brief Check, if type is deserializable.
-	 * \tparam T a type to check
-	 */
-	template<class T>
-	concept deserializable = ::fox::serialize::details::builtin_deserializable<T> || ::fox::serialize::details::custom_deserializable<T>;
+			if (position > written || num_bytes > written - position)
+				throw std::out_of_range(std::format("Trying to patch {} bytes at {}, but only {} bytes were written.", num_bytes, position, written));
 
-	/**
-	 * \brief Check, if type is serializable.
-	 * \tparam T a type to check
-	 */
-	template<class T>
-	static constexpr bool is_serializable_v = serializable<T>;
+			(void)std::memcpy(data + position, bytes, num_bytes);
+		}
 
-	/**
-	 * \brief Check, if type is serializable.
-	 * \tparam T a type to check
-	 */
-	template<class T>
-	struct is_serializable : std::bool_constant<is_serializable_v<T>> {};
+		/**
+		 * \brief Overwrites previously written object bytes of the value. Refer to patch(std::size_t, const void*, std::size_t).
+		 * \param position Position of the bytes, e.g. returned by write_placeholder.
+		 * \param value Value to write.
+		 */
+		template<class T> requires std::is_trivially_copyable_v<T>
+		void patch(std::size_t position, const T& value)
+		{
+			patch(position, static_cast<const void*>(std::addressof(value)), sizeof(T));
+		}
 
-	/**
-	 * \brief Check, if type is deserializable.
-	 * \tparam T a type to check
-	 */
-	template<class T>
-	static constexpr bool is_deserializable_v = deserializable<T>;
+		/**
+		 * \brief Checks if bit_writer only counts written bytes.
+		 */
+		[[nodiscard]] bool counting() const noexcept
+		{
+			return mode_ == mode::counting;
+		}
 
-	/**
-	 * \brief Check, if type is deserializable.
-	 * \tparam T a type to check
-	 */
-	template<class T>
-	struct is_deserializable : std::bool_constant<is_deserializable_v<T>> {};
+		/**
+		 * \brief Checks if the data didn't fit into the caller provided storage with overflow_policy::report.
+		 * Overflowed bit_writer only counts written bytes, size() returns the size the storage would need, until clear() is called.
+		 */
+		[[nodiscard]] bool overflowed() const noexcept
+		{
+			return external_.overflowed;
+		}
 
-	namespace details
-	{
-		template<::fox::serialize::serializable T>
-		FOX_SERIALIZE_INLINE void do_serialize(bit_writer& lhs, const T& rhs)
+	private:
+		// Owned bit_writer checks the mode once, other modes are dispatched here
+		[[nodiscard]] void* write_unowned(std::size_t num_bytes)
 		{
-			if constexpr (::fox::serialize::details::custom_serializable<T>)
-			{
-				if constexpr (custom_serializable_serialize_trait<T>)
-				{
-					serialize_traits<T>::serialize(lhs, rhs);
-				}
-				else if constexpr (custom_serializable_member_function<T>)
-				{
-					rhs.serialize(lhs);
-				}
-				else if constexpr(custom_serializable_static_member_function<T>)
-				{
-					T::serialize(lhs, rhs);
-				}
-				else if constexpr(custom_serializable_member_serialize_trait<T>)
-				{
-					T::serialize_trait::serialize(lhs, rhs);
-				}
-			}
-			else
+			if (mode_ == mode::counting)
+				return count_bytes(num_bytes);
+
+			return write_external(num_bytes);
+		}
+
+		void write_unowned(const void* bytes, std::size_t num_bytes)
+		{
+			if (mode_ == mode::counting)
 			{
-				return ::fox::serialize::details::builtin_serialize_traits<T>::serialize(lhs, rhs);
+				counted_ += num_bytes;
+				return;
 			}
+
+			if (num_bytes != 0)
+				(void)std::memcpy(write_external(num_bytes), bytes, num_bytes);
 		}
 
-		template<::fox::serialize::deserializable T>
-		FOX_SERIALIZE_INLINE void do_deserialize(bit_reader& lhs, T& rhs)
+		[[nodiscard]] FOX_SERIALIZE_INLINE void* write_external(std::size_t num_bytes)
 		{
-			if constexpr (::fox::serialize::details::custom_deserializable<T>)
+			if (num_bytes > external_.capacity - counted_) [[unlikely]]
+				return overflow(num_bytes);
+
+			void* ptr = static_cast<void*>(external_.data + counted_);
+			counted_ += num_bytes;
+			return ptr;
+		}
+
+		void grow_external(std::size_t required)
+		{
+			const std::span<std::byte> storage = external_.growable->grow(required);
+			if (std::size(storage) < required)
+				throw buffer_overflow(required);
+
+			external_.data = std::data(storage);
+			external_.capacity = std::size(storage);
+		}
+
+		void* overflow(std::size_t num_bytes)
+		{
+			if (external_.growable != nullptr)
 			{
-				if constexpr(custom_deserializable_serializable_trait<T>)
-				{
-					serialize_traits<T>::deserialize(lhs, rhs);
-				}
-				else if constexpr(custom_deserializable_member_function<T>)
-				{
-					rhs.deserialize(lhs);
-				}
-				else if constexpr(custom_deserializable_static_member_function<T>)
-				{
-					T::deserialize(lhs, rhs);
-				}
-				else if constexpr(custom_deserializable_member_serialize_trait<T>)
-				{
-					T::serialize_trait::deserialize(lhs, rhs);
-				}
-				else if constexpr(custom_deserializable_construct<T>)
-				{
-					rhs = T(from_bit_reader, lhs);
-				}
+				if (num_bytes > std::numeric_limits<std::size_t>::max() - counted_)
+					throw buffer_overflow(num_bytes);
+
+				grow_external(counted_ + num_bytes);
+				void* ptr = static_cast<void*>(external_.data + counted_);
+				counted_ += num_bytes;
+				return ptr;
 			}
-			else
+
+			if (external_.spill != nullptr)
 			{
-				return ::fox::serialize::details::builtin_serialize_traits<T>::deserialize(lhs, rhs);
+				const std::span<std::byte> storage = external_.spill(external_.context, { external_.data, counted_ }, num_bytes);
+				external_.spilled += counted_;
+				external_.data = std::data(storage);
+				external_.capacity = std::size(storage);
+				counted_ = 0;
+				if (std::size(storage) < num_bytes)
+					throw buffer_overflow(num_bytes);
+
+				counted_ = num_bytes;
+				return static_cast<void*>(external_.data);
+			}
+
+			if (external_.policy == overflow_policy::report)
+			{
+				external_.overflowed = true;
+				mode_ = mode::counting;
+				counted_ += external_.spilled;
+				return count_bytes(num_bytes);
 			}
+
+			throw buffer_overflow(external_.spilled + counted_ + num_bytes);
 		}
-	}
+
+		void* count_bytes(std::size_t num_bytes)
+		{
+			counted_ += num_bytes;
+			if (num_bytes <= counting_scratch_size)
+			{
+				alignas(std::max_align_t) static thread_local std::byte scratch[counting_scratch_size];
+				return static_cast<void*>(scratch);
+			}
+
+			// Builtin traits write larger data with write_bytes(bytes, num_bytes), only custom writes get here.
+			// Written data is discarded, so every counting bit_writer of the thread shares the sink sized for the largest write.
+			static thread_local std::unique_ptr<std::byte[]> sink;
+			static thread_local std::size_t sink_size = 0;
+			if (sink_size < num_bytes)
+			{
+				sink = std::make_unique_for_overwrite<std::byte[]>(num_bytes);
+				sink_size = num_bytes;
+			}
+
+			return static_cast<void*>(sink.get());
+		}
+
+		[[nodiscard]] static mode copyable_mode(const bit_writer& other)
+		{
+			if (other.mode_ == mode::external)
+				throw std::logic_error("bit_writer writing into the caller provided storage can't be copied");
+
+			return other.mode_;
+		}
+	};
+
+	/**
+	 * \brief bit_writer writing into the caller provided storage, it never allocates memory for the written data.
+	 * Storage has to outlive the writer. The writer is move-only, so two writers never write into the same storage.
+	 */
+	class external_bit_writer : public bit_writer
+	{
+	public:
+		/**
+		 * \brief Constructs external_bit_writer writing into the storage.
+		 * \param storage Storage to write to.
+		 * \param policy Behaviour when the data doesn't fit into the storage.
+		 */
+		explicit external_bit_writer(std::span<std::byte> storage, overflow_policy policy = overflow_policy::throw_exception)
+			: bit_writer(storage, policy) {}
+
+		/**
+		 * \brief Constructs external_bit_writer writing into the storage, spilling full storage to the callback.
+		 * \param storage Storage to write to.
+		 * \param spill Function called with the filled storage when the next write doesn't fit into it, returns the storage to continue with.
+		 * \param context Pointer passed to spill.
+		 */
+		external_bit_writer(std::span<std::byte> storage, spill_function spill, void* context = nullptr)
+			: bit_writer(storage, spill, context) {}
+
+		/**
+		 * \brief Constructs external_bit_writer writing into the growable storage, e.g. page_storage. Written data stays contiguous,
+		 * the storage grows in place instead of copying the data into a larger buffer.
+		 * \param storage Storage to write to.
+		 */
+		explicit external_bit_writer(growable_storage& storage)
+			: bit_writer(storage) {}
+
+		external_bit_writer(const external_bit_writer&) = delete;
+		external_bit_writer& operator=(const external_bit_writer&) = delete;
+
+		/**
+		 * \brief Move constructor. Other is left empty, it no longer refers to the storage.
+		 */
+		external_bit_writer(external_bit_writer&& other) noexcept = default;
+
+		/**
+		 * \brief Move assignment operator. Other is left empty, it no longer refers to the storage.
+		 * \return *this
+		 */
+		external_bit_writer& operator=(external_bit_writer&& other) noexcept = default;
+	};
+
+	/**
+	 * \brief Tag type used for the constructor disambiguation.
+	 * Refer to samples/sample_custom_3.cpp
+	 */
+	struct from_bit_reader_t {};
+
+	/**
+	 * \brief Tag used for the constructor disambiguation.
+	 * Refer to samples/sample_custom_3.cpp
+	 */
+	constexpr from_bit_reader_t from_bit_reader;
+
+	/**
+	 * \brief Exception thrown when bit_reader runs out of data.
+	 */
+	class end_of_buffer : public std::out_of_range
+	{
+		std::size_t missing_;
+
+	public:
+		/**
+		 * \brief Constructs end_of_buffer exception.
+		 * \param missing Number of bytes missing to complete the read.
+		 */
+		explicit end_of_buffer(std::size_t missing)
+			: std::out_of_range("Trying to serialize data that is out of range."), missing_(missing) {}
+
+		/**
+		 * \brief Number of bytes missing to complete the read that failed.
+		 */
+		[[nodiscard]] std::size_t missing() const noexcept
+		{
+			return missing_;
+		}
+	};
+
+	/**
+	 * \brief Memory resource allocating every block with at least the given alignment.
+	 * Storage of bit_reader constructed with it is aligned for in-place access to the aligned layout, refer to bit_writer::set_alignment.
+	 */
+	class aligned_memory_resource : public std::pmr::memory_resource
+	{
+		std::pmr::memory_resource* upstream_;
+		std::size_t alignment_;
+
+	public:
+		/**
+		 * \brief Constructs aligned_memory_resource.
+		 * \param alignment Minimal alignment of the allocated blocks, power of two.
+		 * \param upstream Memory resource the blocks are allocated from.
+		 */
+		explicit aligned_memory_resource(std::size_t alignment, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: upstream_(upstream), alignment_(alignment) {}
+
+		/**
+		 * \brief Minimal alignment of the allocated blocks.
+		 */
+		[[nodiscard]] std::size_t alignment() const noexcept
+		{
+			return alignment_;
+		}
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			return upstream_->allocate(bytes, std::max(alignment, alignment_));
+		}
+
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+		{
+			upstream_->deallocate(p, bytes, std::max(alignment, alignment_));
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == std::addressof(other);
+		}
+	};
+
+	/**
+	 * \brief Resources deserialization may use, protecting against corrupted or hostile data. Refer to bit_reader::set_limits.
+	 */
+	struct decode_limits
+	{
+		// Maximum number of bytes allocated for deserialized containers, strings and pointees, until bit_reader is reset
+		std::size_t max_allocated_bytes = std::numeric_limits<std::size_t>::max();
+		// Maximum number of elements of a single container
+		std::size_t max_elements = std::numeric_limits<std::size_t>::max();
+		// Maximum nesting depth of containers and pointees
+		std::size_t max_depth = std::numeric_limits<std::size_t>::max();
+	};
+
+	/**
+	 * \brief Limit of decode_limits.
+	 */
+	enum class decode_limit : std::uint8_t
+	{
+		allocated_bytes,
+		elements,
+		depth
+	};
+
+	/**
+	 * \brief Exception thrown when deserialized data exceeds decode_limits of the bit_reader.
+	 */
+	class decode_limit_exceeded : public std::length_error
+	{
+		decode_limit limit_;
+
+	public:
+		/**
+		 * \brief Constructs decode_limit_exceeded exception.
+		 * \param limit Exceeded limit.
+		 */
+		explicit decode_limit_exceeded(decode_limit limit)
+			: std::length_error(
+				limit == decode_limit::allocated_bytes ? "Deserialized data exceeds the allocated bytes limit." :
+				limit == decode_limit::elements ? "Deserialized data exceeds the container elements limit." :
+				"Deserialized data exceeds the nesting depth limit."), limit_(limit) {}
+
+		/**
+		 * \brief Exceeded limit.
+		 */
+		[[nodiscard]] decode_limit limit() const noexcept
+		{
+			return limit_;
+		}
+	};
+
+	/**
+	 * \brief Implements raw byte buffer that can be read from.
+	 */
+	class bit_reader
+	{
+		std::pmr::vector<std::byte> buffer_;
+		std::size_t offset_{};
+		string_dictionary* strings_ = nullptr;
+		std::unique_ptr<details::reader_object_table> objects_;
+		decode_limits limits_;
+		std::size_t allocated_{};
+		std::size_t depth_{};
+		std::size_t alignment_{};
+		// Position of the first byte of buffer_ in the data, advanced by discard_consumed
+		std::size_t origin_{};
+	public:
+		/**
+		 * \brief Saved state of the bit_reader. Refer to bit_reader::mark.
+		 */
+		struct marker
+		{
+			std::size_t position;
+			std::size_t strings;
+			std::size_t objects;
+			std::size_t allocated;
+		};
+
+	public:
+		/**
+		 * \brief Default constructor. Constructs empty bit_reader.
+		 */
+		bit_reader() = default;
+
+		/**
+		 * \brief Constructs an empty bit_reader with the given memory resource.
+		 * \param mr Memory resource to construct bit_reader with.
+		 */
+		bit_reader(std::pmr::memory_resource* mr)
+			: buffer_(std::pmr::polymorphic_allocator{ mr }), offset_(static_cast<std::size_t>(0)) {}
+
+		/**
+		 * \brief Copy constructor. Constructs bit_reader with the copy of the contents of the other.
+		 * \param other bit_reader to copy contents from
+		 */
+		bit_reader(const bit_reader& other) : buffer_(other.buffer_), offset_(other.offset_), strings_(other.strings_),
+			objects_(other.objects_ ? std::make_unique<details::reader_object_table>(*other.objects_) : nullptr),
+			limits_(other.limits_), allocated_(other.allocated_), depth_(other.depth_), alignment_(other.alignment_), origin_(other.origin_) {}
+
+		/**
+		 * \brief Move constructor. Constructs bit_reader with the contents of other using move semantics.
+		 * \param other bit_reader to move contents from
+		 */
+		bit_reader(bit_reader&& other) noexcept
+			: buffer_(std::exchange(other.buffer_, {})), offset_(std::exchange(other.offset_, {})), strings_(std::exchange(other.strings_, nullptr)),
+			objects_(std::move(other.objects_)), limits_(other.limits_), allocated_(std::exchange(other.allocated_, {})), depth_(std::exchange(other.depth_, {})),
+			alignment_(other.alignment_), origin_(std::exchange(other.origin_, {}))
+		{}
+
+		/**
+		 * \brief Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		 * \param other bit_reader to copy contents from
+		 * \return *this
+		 */
+		bit_reader& operator=(const bit_reader& other)
+		{
+			if (this != std::addressof(other))
+			{
+				buffer_ = other.buffer_;
+				offset_ = other.offset_;
+				strings_ = other.strings_;
+				objects_ = other.objects_ ? std::make_unique<details::reader_object_table>(*other.objects_) : nullptr;
+				limits_ = other.limits_;
+				allocated_ = other.allocated_;
+				depth_ = other.depth_;
+				alignment_ = other.alignment_;
+				origin_ = other.origin_;
+			}
+			return *this;
+		}
+
+		/**
+		 * \brief Move assignment operator. Replaces the contents with those of other using move semantics.
+		 * \param other bit_reader to move contents from
+		 * \return *this
+		 */
+		bit_reader& operator=(bit_reader&& other) noexcept
+		{
+			buffer_ = std::exchange(other.buffer_, {});
+			offset_ = std::exchange(other.offset_, {});
+			strings_ = std::exchange(other.strings_, nullptr);
+			objects_ = std::move(other.objects_);
+			limits_ = other.limits_;
+			allocated_ = std::exchange(other.allocated_, {});
+			depth_ = std::exchange(other.depth_, {});
+			alignment_ = other.alignment_;
+			origin_ = std::exchange(other.origin_, {});
+			return *this;
+		}
+
+		/**
+		 * \brief Constructs bit_reader with the contents of the range.
+		 * \tparam Range Range of trivial types convertible to the range of bytes.
+		 * \param range Range of trivial types convertible to the range of bytes.
+		 */
+		template<std::ranges::range Range>
+		bit_reader(std::from_range_t, Range && range)
+			requires std::is_trivial_v<std::ranges::range_value_t<Range>>
+		{
+			using value_type = std::ranges::range_value_t<Range>;
+			if constexpr (std::ranges::contiguous_range<Range>)
+			{
+				auto span = std::as_bytes(std::span(range));
+				buffer_ = span | std::ranges::to<std::pmr::vector<std::byte>>();
+			}
+			else
+			{
+				auto it = std::begin(range);
+				auto end = std::end(range);
+				buffer_ = std::ranges::subrange(it, end)
+					| std::transform(
+					[](const value_type& v) -> std::array<std::byte, sizeof(value_type)>
+					{ return std::bit_cast<std::array<std::byte, sizeof(value_type)>>(v); })
+					| std::views::join
+					| std::ranges::to<std::vector<std::byte>>();
+			}
+		}
+
+		/**
+		 * \brief Destructor of the bit_reader.
+		 */
+		~bit_reader() noexcept = default;
+
+	public:
+		/**
+		 * \brief Returns the allocator associated with the bit_writer.
+		 * \return The associated allocator.
+		 */
+		auto get_allocator() const noexcept -> decltype(buffer_)::allocator_type
+		{
+			return buffer_.get_allocator();
+		}
+
+	public:
+		/**
+		 * \brief Enables string deduplication. Data has to be written by bit_writer with the dictionary containing the same strings.
+		 * \param dictionary Dictionary to use, nullptr disables deduplication.
+		 */
+		void set_string_dictionary(string_dictionary* dictionary) noexcept
+		{
+			strings_ = dictionary;
+		}
+
+		/**
+		 * \brief Returns the string dictionary, nullptr if string deduplication is disabled.
+		 */
+		[[nodiscard]] string_dictionary* get_string_dictionary() const noexcept
+		{
+			return strings_;
+		}
+
+	public:
+		/**
+		 * \brief Enables the aligned layout, data has to be written by bit_writer with the same alignment.
+		 * Refer to bit_writer::set_alignment. Storage of the reader has to be aligned too for in-place access, e.g. with aligned_memory_resource.
+		 * \param alignment Power of two, 1 aligns to alignof(T), 0 disables padding.
+		 * \throws std::invalid_argument if the alignment isn't a power of two or 0
+		 */
+		void set_alignment(std::size_t alignment)
+		{
+			if (alignment != 0 && !std::has_single_bit(alignment))
+				throw std::invalid_argument("Alignment has to be a power of two.");
+
+			alignment_ = alignment;
+		}
+
+		/**
+		 * \brief Returns the alignment of the aligned layout, 0 if it's disabled.
+		 */
+		[[nodiscard]] std::size_t alignment() const noexcept
+		{
+			return alignment_;
+		}
+
+		/**
+		 * \brief Number of padding bytes written by bit_writer::align at the current position.
+		 * \param alignment Power of two.
+		 */
+		[[nodiscard]] std::size_t padding(std::size_t alignment) const noexcept
+		{
+			return (alignment - (origin_ + offset_) % alignment) % alignment;
+		}
+
+		/**
+		 * \brief Skips padding bytes written by bit_writer::align.
+		 * \param alignment Power of two.
+		 */
+		void align(std::size_t alignment)
+		{
+			(void)read_bytes(padding(alignment));
+		}
+
+	public:
+		/**
+		 * \brief Sets limits of resources deserialization may use. Builtin deserialization checks them before allocating.
+		 * \param limits Limits to use.
+		 */
+		void set_limits(const decode_limits& limits) noexcept
+		{
+			limits_ = limits;
+		}
+
+		/**
+		 * \brief Returns limits of resources deserialization may use.
+		 */
+		[[nodiscard]] const decode_limits& get_limits() const noexcept
+		{
+			return limits_;
+		}
+
+		/**
+		 * \brief Number of bytes accounted as allocated since the last clear() or assign(). Refer to decode_limits::max_allocated_bytes.
+		 */
+		[[nodiscard]] std::size_t allocated() const noexcept
+		{
+			return allocated_;
+		}
+
+		/**
+		 * \brief Accounts for a container of count elements about to be allocated, before allocating it.
+		 * Custom deserialization methods allocating memory based on the read data should call it too.
+		 * \param count Number of elements.
+		 * \param element_size Number of bytes allocated per element.
+		 * \param min_serialized_size Minimal number of bytes every element takes in the data, 0 if unknown.
+		 * \throws decode_limit_exceeded if the container exceeds the limits
+		 * \throws end_of_buffer if the remaining data can't hold count elements
+		 */
+		void charge(std::size_t count, std::size_t element_size, std::size_t min_serialized_size = 0)
+		{
+			if (count > limits_.max_elements)
+				throw decode_limit_exceeded(decode_limit::elements);
+
+			// Data can't hold that many elements, fail before allocating them
+			if (min_serialized_size != 0 && count > remaining() / min_serialized_size)
+			{
+				const std::size_t required = count > std::numeric_limits<std::size_t>::max() / min_serialized_size ?
+					std::numeric_limits<std::size_t>::max() : count * min_serialized_size;
+				throw end_of_buffer(required - remaining());
+			}
+
+			const std::size_t bytes = element_size != 0 && count > std::numeric_limits<std::size_t>::max() / element_size ?
+				std::numeric_limits<std::size_t>::max() : count * element_size;
+			if (bytes > limits_.max_allocated_bytes - std::min(allocated_, limits_.max_allocated_bytes))
+				throw decode_limit_exceeded(decode_limit::allocated_bytes);
+
+			allocated_ += bytes;
+		}
+
+		/**
+		 * \brief Enters a nested container or pointee. Refer to decode_limits::max_depth.
+		 * \throws decode_limit_exceeded if the nesting is too deep
+		 */
+		void enter()
+		{
+			if (depth_ >= limits_.max_depth)
+				throw decode_limit_exceeded(decode_limit::depth);
+
+			++depth_;
+		}
+
+		/**
+		 * \brief Leaves a nested container or pointee entered with enter().
+		 */
+		void leave() noexcept
+		{
+			--depth_;
+		}
+
+	public:
+		/**
+		 * \brief Returns the table of objects read through std::shared_ptr. Released by clear() and assign().
+		 */
+		[[nodiscard]] details::reader_object_table& object_table()
+		{
+			if (!objects_)
+				objects_ = std::make_unique<details::reader_object_table>();
+
+			return *objects_;
+		}
+
+	public:
+		/**
+		 * \brief Erases previously serialized data. Resets bit_writer.
+		 */
+		void clear()
+		{
+			buffer_.clear();
+			offset_ = {};
+			objects_.reset();
+			allocated_ = {};
+			origin_ = {};
+		}
+
+		/**
+		 * \brief Replaces the contents with a copy of the bytes, reusing already allocated storage. Resets bit_reader.
+		 * \param bytes Serialized data to read from.
+		 */
+		void assign(std::span<const std::byte> bytes)
+		{
+			buffer_.assign(std::begin(bytes), std::end(bytes));
+			offset_ = {};
+			objects_.reset();
+			allocated_ = {};
+			origin_ = {};
+		}
+
+		/**
+		 * \brief Appends bytes to the end of the data that is to be deserialized.
+		 * \param bytes Serialized data to append.
+		 */
+		void append(std::span<const std::byte> bytes)
+		{
+			buffer_.insert(std::end(buffer_), std::begin(bytes), std::end(bytes));
+		}
+
+		/**
+		 * \brief Erases already deserialized data. Invalidates positions previously returned by position().
+		 */
+		void discard_consumed()
+		{
+			buffer_.erase(std::begin(buffer_), std::begin(buffer_) + static_cast<std::ptrdiff_t>(offset_));
+			origin_ += offset_;
+			offset_ = {};
+		}
+
+		/**
+		 * \brief Reserves storage for at least new_capacity bytes of serialized data.
+		 * \param new_capacity Number of bytes to reserve.
+		 */
+		void reserve(std::size_t new_capacity)
+		{
+			buffer_.reserve(new_capacity);
+		}
+
+		/**
+		 * \brief Returns the number of bytes that can be stored without reallocation.
+		 * \return Capacity of the underlying storage.
+		 */
+		[[nodiscard]] std::size_t capacity() const noexcept
+		{
+			return buffer_.capacity();
+		}
+
+		/**
+		 * \brief Requests the removal of unused capacity.
+		 */
+		void shrink_to_fit()
+		{
+			buffer_.shrink_to_fit();
+		}
+	public:
+		/**
+		 * \brief Returns the number of bytes that are yet to be deserialized.
+		 */
+		[[nodiscard]] std::size_t remaining() const noexcept
+		{
+			return std::size(buffer_) - offset_;
+		}
+
+		/**
+		 * \brief Returns the offset of the next byte to be deserialized.
+		 */
+		[[nodiscard]] std::size_t position() const noexcept
+		{
+			return offset_;
+		}
+
+		/**
+		 * \brief Sets the offset of the next byte to be deserialized.
+		 * \param position Offset previously returned by position().
+		 */
+		void seek(std::size_t position)
+		{
+			if (position > std::size(buffer_))
+				throw std::out_of_range("Trying to seek past the end of the data.");
+
+			offset_ = position;
+		}
+
+		/**
+		 * \brief Saves the read position together with the number of strings and shared objects read and bytes charged so far.
+		 * \return Marker that can be passed to rewind.
+		 */
+		[[nodiscard]] marker mark() const noexcept
+		{
+			return marker{
+				offset_,
+				strings_ != nullptr ? strings_->size() : 0,
+				objects_ ? std::size(objects_->objects) : 0,
+				allocated_
+			};
+		}
+
+		/**
+		 * \brief Restores the state saved by mark(), forgetting strings and shared objects read and bytes charged after it.
+		 * \param m Marker previously returned by mark().
+		 */
+		void rewind(const marker& m)
+		{
+			seek(m.position);
+			allocated_ = m.allocated;
+
+			if (strings_ != nullptr && strings_->size() > m.strings)
+				strings_->truncate(m.strings);
+
+			if (objects_ && std::size(objects_->objects) > m.objects)
+				objects_->objects.resize(m.objects);
+		}
+
+	public:
+		/**
+		 * \brief Acquires pointer to the data that is to be deserialized.
+		 * \param num_bytes Number of bytes requested to be read.
+		 * \return Pointer to memory, that contains serialized object.
+		 */
+		[[nodiscard]] FOX_SERIALIZE_INLINE const void* read_bytes(std::size_t num_bytes)
+		{
+			if (num_bytes > std::size(buffer_) - offset_)
+				throw end_of_buffer(num_bytes - (std::size(buffer_) - offset_));
+
+			const void* ptr = static_cast<const void*>(std::data(buffer_) + offset_);
+			offset_ += num_bytes;
+			return ptr;
+		}
+
+		/**
+		 * \brief Acquires pointer to the data that is to be deserialized.
+		 * \tparam NumBytes Number of bytes requested to be read.
+		 * \return Pointer to memory, that contains serialized object.
+		 */
+		template<std::size_t NumBytes>
+		[[nodiscard]] FOX_SERIALIZE_INLINE const void* read_bytes()
+		{
+			if (NumBytes > std::size(buffer_) - offset_)
+				throw end_of_buffer(NumBytes - (std::size(buffer_) - offset_));
+
+			const void* ptr = static_cast<const void*>(std::data(buffer_) + offset_);
+			offset_ += NumBytes;
+			return ptr;
+		}
+	};
+
+#pragma endregion streams
+
+#pragma region stream_pool
+	template<class Stream> class stream_pool;
+
+	/**
+	 * \brief Handle to the stream borrowed from the stream_pool. Stream is returned to the pool when the handle is destroyed.
+	 * \tparam Stream bit_writer or bit_reader
+	 */
+	template<class Stream>
+	class pooled_stream
+	{
+		stream_pool<Stream>* pool_ = nullptr;
+		Stream stream_;
+
+		friend class stream_pool<Stream>;
+
+		pooled_stream(stream_pool<Stream>& pool, Stream&& stream) noexcept
+			: pool_(std::addressof(pool)), stream_(std::move(stream)) {}
+
+	public:
+		pooled_stream(const pooled_stream&) = delete;
+		pooled_stream& operator=(const pooled_stream&) = delete;
+
+		/**
+		 * \brief Move constructor. Takes over the ownership of the borrowed stream.
+		 * \param other pooled_stream to move stream from
+		 */
+		pooled_stream(pooled_stream&& other) noexcept
+			: pool_(std::exchange(other.pool_, nullptr)), stream_(std::move(other.stream_)) {}
+
+		/**
+		 * \brief Move assignment operator. Returns currently held stream to its pool and takes over the ownership of other stream.
+		 * \param other pooled_stream to move stream from
+		 * \return *this
+		 */
+		pooled_stream& operator=(pooled_stream&& other) noexcept
+		{
+			if (this != std::addressof(other))
+			{
+				release();
+				pool_ = std::exchange(other.pool_, nullptr);
+				stream_ = std::move(other.stream_);
+			}
+			return *this;
+		}
+
+		/**
+		 * \brief Returns the stream to the pool.
+		 */
+		~pooled_stream() noexcept
+		{
+			release();
+		}
+
+	public:
+		[[nodiscard]] Stream& get() noexcept { return stream_; }
+		[[nodiscard]] const Stream& get() const noexcept { return stream_; }
+		[[nodiscard]] Stream& operator*() noexcept { return stream_; }
+		[[nodiscard]] const Stream& operator*() const noexcept { return stream_; }
+		[[nodiscard]] Stream* operator->() noexcept { return std::addressof(stream_); }
+		[[nodiscard]] const Stream* operator->() const noexcept { return std::addressof(stream_); }
+
+	private:
+		void release() noexcept
+		{
+			if (pool_ != nullptr)
+				std::exchange(pool_, nullptr)->release(std::move(stream_));
+		}
+	};
+
+	/**
+	 * \brief Pool of streams with pre-warmed capacity. Streams that grew above high water mark are trimmed when returned.
+	 * Pool is not thread safe, use stream_pool::thread_local_instance() to get a pool local to the calling thread.
+	 * \tparam Stream bit_writer or bit_reader
+	 */
+	template<class Stream>
+	class stream_pool
+	{
+		std::pmr::vector<Stream> free_;
+		std::pmr::memory_resource* stream_resource_;
+		std::size_t initial_capacity_;
+		std::size_t high_water_mark_;
+		std::size_t max_pooled_;
+
+		friend class pooled_stream<Stream>;
+
+	public:
+		static constexpr std::size_t default_initial_capacity = 4096;
+		static constexpr std::size_t default_high_water_mark = 1024 * 1024;
+		static constexpr std::size_t default_max_pooled = 16;
+
+		/**
+		 * \brief Constructs an empty stream_pool.
+		 * \param initial_capacity Capacity streams are created and trimmed with.
+		 * \param high_water_mark Streams with capacity above this value are trimmed back to initial_capacity when returned.
+		 * \param max_pooled Maximum number of idle streams kept by the pool.
+		 * \param mr Memory resource used by the pooled streams.
+		 */
+		explicit stream_pool(
+			std::size_t initial_capacity = default_initial_capacity, 
+			std::size_t high_water_mark = default_high_water_mark,
+			std::size_t max_pooled = default_max_pooled,
+			std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+			: free_(std::pmr::polymorphic_allocator{ mr }), stream_resource_(mr), initial_capacity_(initial_capacity),
+			high_water_mark_(high_water_mark), max_pooled_(max_pooled)
+		{
+			free_.reserve(max_pooled_);
+		}
+
+		stream_pool(const stream_pool&) = delete;
+		stream_pool& operator=(const stream_pool&) = delete;
+
+	public:
+		/**
+		 * \brief Borrows an empty stream from the pool. Constructs a new one if the pool is empty.
+		 * \return Handle returning the stream back to the pool on destruction.
+		 */
+		[[nodiscard]] pooled_stream<Stream> acquire()
+		{
+			if (std::empty(free_))
+				return pooled_stream<Stream>(*this, make_stream());
+
+			Stream stream = std::move(free_.back());
+			free_.pop_back();
+			return pooled_stream<Stream>(*this, std::move(stream));
+		}
+
+		/**
+		 * \brief Number of idle streams in the pool.
+		 */
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			return std::size(free_);
+		}
+
+		/**
+		 * \brief Releases all idle streams.
+		 */
+		void clear() noexcept
+		{
+			free_.clear();
+		}
+
+		/**
+		 * \brief Returns the pool local to the calling thread, constructed with the default settings.
+		 */
+		[[nodiscard]] static stream_pool& thread_local_instance()
+		{
+			thread_local stream_pool pool;
+			return pool;
+		}
+
+	private:
+		[[nodiscard]] Stream make_stream() const
+		{
+			Stream stream(stream_resource_);
+			stream.reserve(initial_capacity_);
+			return stream;
+		}
+
+		void release(Stream&& stream) noexcept
+		{
+			if (std::size(free_) >= max_pooled_)
+				return;
+
+			try
+			{
+				stream.clear();
+				if (stream.capacity() > high_water_mark_)
+				{
+					stream.shrink_to_fit();
+					stream.reserve(initial_capacity_);
+				}
+				free_.push_back(std::move(stream));
+			}
+			catch (...)
+			{
+				// Failing to return a stream to the pool is not an error, stream is simply destroyed
+			}
+		}
+	};
+
+	/**
+	 * \brief Pool of bit_writers.
+	 */
+	using writer_pool = stream_pool<bit_writer>;
+
+	/**
+	 * \brief Pool of bit_readers.
+	 */
+	using reader_pool = stream_pool<bit_reader>;
+
+	/**
+	 * \brief Borrows a bit_writer from the pool local to the calling thread.
+	 * \return Handle returning the bit_writer back to the pool on destruction.
+	 */
+	[[nodiscard]] inline pooled_stream<bit_writer> acquire_writer()
+	{
+		return writer_pool::thread_local_instance().acquire();
+	}
+
+	/**
+	 * \brief Borrows a bit_reader from the pool local to the calling thread.
+	 * \return Handle returning the bit_reader back to the pool on destruction.
+	 */
+	[[nodiscard]] inline pooled_stream<bit_reader> acquire_reader()
+	{
+		return reader_pool::thread_local_instance().acquire();
+	}
+#pragma endregion stream_pool
+
+#pragma region varint
+	namespace details
+	{
+		// Maximum number of bytes LEB128 encoding of 64-bit integer takes
+		constexpr std::size_t max_varint_size = 10;
+
+		/**
+		 * \brief Encodes value as unsigned LEB128 into out.
+		 * \return Number of bytes written.
+		 */
+		inline std::size_t encode_varint(std::uint64_t value, std::byte* out) noexcept
+		{
+			std::size_t n = 0;
+			while (value >= 0x80)
+			{
+				out[n++] = static_cast<std::byte>(value | 0x80);
+				value >>= 7;
+			}
+			out[n++] = static_cast<std::byte>(value);
+			return n;
+		}
+
+		/**
+		 * \brief Decodes unsigned LEB128 from the beginning of bytes.
+		 * \return Number of bytes consumed, 0 if bytes end before the varint does.
+		 */
+		inline std::size_t decode_varint(std::span<const std::byte> bytes, std::uint64_t& value)
+		{
+			std::uint64_t result = 0;
+			const std::size_t limit = std::min(std::size(bytes), max_varint_size);
+			for (std::size_t i = 0; i < limit; ++i)
+			{
+				const auto b = static_cast<std::uint64_t>(bytes[i]);
+				result |= (b & 0x7F) << (7 * i);
+				if ((b & 0x80) == 0)
+				{
+					if (i == max_varint_size - 1 && b > 1)
+						throw std::invalid_argument("Varint overflows 64-bit integer.");
+
+					value = result;
+					return i + 1;
+				}
+			}
+
+			if (limit == max_varint_size)
+				throw std::invalid_argument("Varint is longer than 10 bytes.");
+
+			return 0;
+		}
+
+		/**
+		 * \brief Number of bytes unsigned LEB128 encoding of value takes.
+		 */
+		constexpr std::size_t varint_size(std::uint64_t value) noexcept
+		{
+			return (static_cast<std::size_t>(std::bit_width(value | 1)) + 6) / 7;
+		}
+
+		inline void write_varint(bit_writer& writer, std::uint64_t value)
+		{
+			std::array<std::byte, max_varint_size> bytes;
+			const std::size_t n = encode_varint(value, std::data(bytes));
+			writer.write_bytes(std::data(bytes), n);
+		}
+
+		inline std::uint64_t read_varint(bit_reader& reader)
+		{
+			std::uint64_t result = 0;
+			for (std::size_t i = 0; i < max_varint_size; ++i)
+			{
+				const auto b = static_cast<std::uint64_t>(*static_cast<const std::byte*>(reader.read_bytes<1>()));
+				result |= (b & 0x7F) << (7 * i);
+				if ((b & 0x80) == 0)
+				{
+					if (i == max_varint_size - 1 && b > 1)
+						throw std::invalid_argument("Varint overflows 64-bit integer.");
+
+					return result;
+				}
+			}
+
+			throw std::invalid_argument("Varint is longer than 10 bytes.");
+		}
+	}
+#pragma endregion varint
+
+#pragma region type_name
+	namespace details
+	{
+		template<class T>
+		[[nodiscard]] constexpr std::string_view raw_type_name() noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			return __FUNCSIG__;
+#else
+			return __PRETTY_FUNCTION__;
+#endif
+		}
+
+		template<class T>
+		[[nodiscard]] constexpr std::string_view type_name() noexcept
+		{
+			constexpr std::string_view probe = raw_type_name<int>();
+			constexpr std::size_t prefix = probe.find("int");
+			constexpr std::size_t suffix = std::size(probe) - prefix - std::size(std::string_view("int"));
+
+			constexpr std::string_view name = raw_type_name<T>();
+			return name.substr(prefix, std::size(name) - prefix - suffix);
+		}
+	}
+#pragma endregion type_name
+
+#pragma region instrumentation
+#ifdef FOX_SERIALIZE_INSTRUMENTATION
+	/**
+	 * \brief Operation reported by the instrumentation.
+	 */
+	enum class instrumentation_operation
+	{
+		serialize,
+		deserialize
+	};
+
+	/**
+	 * \brief Event reported to the instrumentation_sink after an object was serialized or deserialized.
+	 */
+	struct instrumentation_event
+	{
+		instrumentation_operation operation;
+
+		// Name of the serialized type
+		std::string_view type_name;
+
+		// Names of the types from the outermost object to this one, the last element is type_name
+		std::span<const std::string_view> path;
+
+		// Number of bytes produced or consumed, including nested objects
+		std::size_t bytes;
+
+		// Number of cycles spent, including nested objects. 0 if the sink doesn't measure cycles
+		std::uint64_t cycles;
+	};
+
+	/**
+	 * \brief Receives instrumentation events. Requires FOX_SERIALIZE_INSTRUMENTATION to be defined.
+	 */
+	class instrumentation_sink
+	{
+	public:
+		virtual ~instrumentation_sink() = default;
+
+		/**
+		 * \brief Called after every serialized or deserialized object.
+		 * \param event Reported event, path is only valid for the duration of the call.
+		 */
+		virtual void record(const instrumentation_event& event) = 0;
+
+		/**
+		 * \brief Checks if the cycle counter should be read around every object.
+		 */
+		[[nodiscard]] virtual bool measure_cycles() const noexcept
+		{
+			return false;
+		}
+	};
+
+	namespace details
+	{
+		[[nodiscard]] inline instrumentation_sink*& current_instrumentation_sink() noexcept
+		{
+			thread_local instrumentation_sink* sink = nullptr;
+			return sink;
+		}
+
+		[[nodiscard]] inline std::vector<std::string_view>& instrumentation_path()
+		{
+			thread_local std::vector<std::string_view> path;
+			return path;
+		}
+
+		[[nodiscard]] inline std::uint64_t read_cycle_counter() noexcept
+		{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#else
+			return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		[[nodiscard]] inline std::size_t instrumentation_bytes(const bit_writer& writer) noexcept
+		{
+			return writer.size();
+		}
+
+		[[nodiscard]] inline std::size_t instrumentation_bytes(const bit_reader& reader) noexcept
+		{
+			return reader.position();
+		}
+
+		// Reports the object serialized during the lifetime of the scope, unless it was left with an exception
+		template<class Stream>
+		class instrumentation_scope
+		{
+			instrumentation_sink* sink_;
+			const Stream& stream_;
+			instrumentation_operation operation_;
+			std::size_t bytes_{};
+			std::uint64_t cycles_{};
+			int exceptions_{};
+
+		public:
+			FOX_SERIALIZE_INLINE instrumentation_scope(const Stream& stream, instrumentation_operation operation, std::string_view name)
+				: sink_(current_instrumentation_sink()), stream_(stream), operation_(operation)
+			{
+				if (sink_ == nullptr)
+					return;
+
+				instrumentation_path().push_back(name);
+				bytes_ = instrumentation_bytes(stream_);
+				exceptions_ = std::uncaught_exceptions();
+				if (sink_->measure_cycles())
+					cycles_ = read_cycle_counter();
+			}
+
+			instrumentation_scope(const instrumentation_scope&) = delete;
+			instrumentation_scope& operator=(const instrumentation_scope&) = delete;
+
+			FOX_SERIALIZE_INLINE ~instrumentation_scope() noexcept
+			{
+				if (sink_ == nullptr)
+					return;
+
+				auto& path = instrumentation_path();
+				if (std::uncaught_exceptions() == exceptions_)
+				{
+					const std::uint64_t cycles = sink_->measure_cycles() ? read_cycle_counter() - cycles_ : 0;
+					sink_->record(instrumentation_event
+					{
+						.operation = operation_,
+						.type_name = path.back(),
+						.path = path,
+						.bytes = instrumentation_bytes(stream_) - bytes_,
+						.cycles = cycles
+					});
+				}
+				path.pop_back();
+			}
+		};
+	}
+
+	/**
+	 * \brief Sets the sink receiving instrumentation events on the calling thread.
+	 * \param sink Sink to report to, nullptr disables reporting.
+	 * \return Previously set sink.
+	 */
+	inline instrumentation_sink* set_instrumentation_sink(instrumentation_sink* sink) noexcept
+	{
+		return std::exchange(::fox::serialize::details::current_instrumentation_sink(), sink);
+	}
+#endif
+#pragma endregion instrumentation
+
+#pragma region traits
+	/**
+	 * \brief Trait class used to provide serialization methods for a given type.
+	 * \tparam T Serialized type.
+	 */
+	template<class T> struct serialize_traits;
+
+	/**
+	 * \brief Trait class used to opt an enum into the compact encoding. Specializations provide the declared range of the enum:
+	 * static constexpr T min and static constexpr T max. The enum is written as the offset from min in the smallest unsigned
+	 * integer covering the range, and values outside of the range are rejected when read.
+	 * \tparam T Enum type.
+	 */
+	template<class T> struct enum_range;
+
+	namespace details
+	{
+		// Internal serialization trait, selected if no public serialize_traits is available
+		template<class T> struct builtin_serialize_traits;
+
+		// Number of bytes value serializes to, counter is the counting bit_writer used for types without their own measure
+		template<class T>
+		std::size_t dynamic_serialized_size(const T& value, bit_writer& counter);
+
+		// Builtin traits measuring the value next to its serialize method, other types are run with the counting bit_writer
+		template<class T>
+		concept builtin_sized = requires (bit_writer & counter, const T & a)
+		{
+			{ ::fox::serialize::details::builtin_serialize_traits<T>::serialized_size(a, counter)	} -> std::same_as<std::size_t>;
+		};
+
+		template<class T>
+		concept ranged_enum = std::is_enum_v<T> && requires
+		{
+			{ enum_range<T>::min } -> std::convertible_to<T>;
+			{ enum_range<T>::max } -> std::convertible_to<T>;
+		};
+
+		template<class T>
+		concept builtin_serializable = requires (bit_writer & writer, const T & a)
+		{
+			{ ::fox::serialize::details::builtin_serialize_traits<T>::serialize(writer, a)		} -> std::same_as<void>;
+		};
+
+		template<class T>
+		concept builtin_deserializable = requires (bit_reader & reader, T & b)
+		{
+			{ ::fox::serialize::details::builtin_serialize_traits<T>::deserialize(reader, b)	} -> std::same_as<void>;
+		};
+
+		template<class T>
+		concept custom_serializable_serialize_trait = requires (bit_writer & writer, const T & a)
+		{
+			serialize_traits<T>::serialize(writer, a);
+		};
+
+		template<class T>
+		concept custom_serializable_member_function = requires (bit_writer & writer, const T & a)
+		{
+			a.serialize(writer);
+		};
+
+		template<class T>
+		concept custom_serializable_static_member_function = requires (bit_writer & writer, const T & a)
+		{
+			T::serialize(writer, a);
+		};
+
+		template<class T>
+		concept custom_serializable_member_serialize_trait = requires (bit_writer & writer, const T & a)
+		{
+			T::serialize_trait::serialize(writer, a);
+		};
+
+		template<class T>
+		concept custom_serializable =
+			custom_serializable_serialize_trait<T> ||
+			custom_serializable_member_function<T> ||
+			custom_serializable_static_member_function<T> ||
+			custom_serializable_member_serialize_trait<T>;
+
+		template<class T>
+		concept custom_deserializable_serializable_trait = requires (bit_reader & reader, T & b)
+		{
+			serialize_traits<T>::deserialize(reader, b);
+		};
+
+		template<class T>
+		concept custom_deserializable_member_function = requires (bit_reader & reader, T& a)
+		{
+			a.deserialize(reader);
+		};
+
+		template<class T>
+		concept custom_deserializable_static_member_function = requires (bit_reader & reader, T& a)
+		{
+			T::deserialize(reader, a);
+		};
+
+		template<class T>
+		concept custom_deserializable_member_serialize_trait = requires (bit_reader & reader, T& a)
+		{
+			T::serialize_trait::deserialize(reader, a);
+		};
+
+		template<class T>
+		concept custom_deserializable_construct = requires (bit_reader & reader, T & a)
+		{
+			a = T(from_bit_reader, reader);
+		};
+
+		template<class T>
+		concept custom_deserializable =
+			custom_deserializable_serializable_trait<T> ||
+			custom_deserializable_member_function<T> ||
+			custom_deserializable_static_member_function<T> ||
+			custom_deserializable_member_serialize_trait<T> ||
+			custom_deserializable_construct<T>;
+	}
+
+	/**
+	 * \brief Check, if type is serializable.
+	 * \tparam T a type to check
+	 */
+	template<class T>
+	concept serializable = ::fox::serialize::details::builtin_serializable<T> || ::fox::serialize::details::custom_serializable<T>;
+
+	/**
+	 * \brief Check, if type is deserializable.
+	 * \tparam T a type to check
+	 */
+	template<class T>
+	concept deserializable = ::fox::serialize::details::builtin_deserializable<T> || ::fox::serialize::details::custom_deserializable<T>;
+
+	/**
+	 * \brief Check, if type is serializable.
+	 * \tparam T a type to check
+	 */
+	template<class T>
+	static constexpr bool is_serializable_v = serializable<T>;
+
+	/**
+	 * \brief Check, if type is serializable.
+	 * \tparam T a type to check
+	 */
+	template<class T>
+	struct is_serializable : std::bool_constant<is_serializable_v<T>> {};
+
+	/**
+	 * \brief Check, if type is deserializable.
+	 * \tparam T a type to check
+	 */
+	template<class T>
+	static constexpr bool is_deserializable_v = deserializable<T>;
+
+	/**
+	 * \brief Check, if type is deserializable.
+	 * \tparam T a type to check
+	 */
+	template<class T>
+	struct is_deserializable : std::bool_constant<is_deserializable_v<T>> {};
+
+	namespace details
+	{
+#ifdef FOX_SERIALIZE_INSTRUMENTATION
+		template<::fox::serialize::serializable T>
+		void do_serialize_impl(bit_writer& lhs, const T& rhs);
+
+		template<::fox::serialize::deserializable T>
+		void do_deserialize_impl(bit_reader& lhs, T& rhs);
+#endif
+
+		template<::fox::serialize::serializable T>
+		FOX_SERIALIZE_INLINE void do_serialize(bit_writer& lhs, const T& rhs)
+		{
+#ifdef FOX_SERIALIZE_INSTRUMENTATION
+			// References and const types are forwarded to do_serialize<T>, they are reported there
+			if constexpr (std::is_same_v<T, std::remove_cvref_t<T>>)
+			{
+				instrumentation_scope<bit_writer> scope(lhs, instrumentation_operation::serialize, type_name<T>());
+				do_serialize_impl<T>(lhs, rhs);
+			}
+			else
+			{
+				do_serialize_impl<T>(lhs, rhs);
+			}
+		}
+
+		template<::fox::serialize::serializable T>
+		FOX_SERIALIZE_INLINE void do_serialize_impl(bit_writer& lhs, const T& rhs)
+		{
+#endif
+			if constexpr (::fox::serialize::details::custom_serializable<T>)
+			{
+				if constexpr (custom_serializable_serialize_trait<T>)
+				{
+					serialize_traits<T>::serialize(lhs, rhs);
+				}
+				else if constexpr (custom_serializable_member_function<T>)
+				{
+					rhs.serialize(lhs);
+				}
+				else if constexpr(custom_serializable_static_member_function<T>)
+				{
+					T::serialize(lhs, rhs);
+				}
+				else if constexpr(custom_serializable_member_serialize_trait<T>)
+				{
+					T::serialize_trait::serialize(lhs, rhs);
+				}
+			}
+			else
+			{
+				return ::fox::serialize::details::builtin_serialize_traits<T>::serialize(lhs, rhs);
+			}
+		}
+
+		template<::fox::serialize::deserializable T>
+		FOX_SERIALIZE_INLINE void do_deserialize(bit_reader& lhs, T& rhs)
+		{
+#ifdef FOX_SERIALIZE_INSTRUMENTATION
+			if constexpr (std::is_same_v<T, std::remove_cvref_t<T>>)
+			{
+				instrumentation_scope<bit_reader> scope(lhs, instrumentation_operation::deserialize, type_name<T>());
+				do_deserialize_impl<T>(lhs, rhs);
+			}
+			else
+			{
+				do_deserialize_impl<T>(lhs, rhs);
+			}
+		}
+
+		template<::fox::serialize::deserializable T>
+		FOX_SERIALIZE_INLINE void do_deserialize_impl(bit_reader& lhs, T& rhs)
+		{
+#endif
+			if constexpr (::fox::serialize::details::custom_deserializable<T>)
+			{
+				if constexpr(custom_deserializable_serializable_trait<T>)
+				{
+					serialize_traits<T>::deserialize(lhs, rhs);
+				}
+				else if constexpr(custom_deserializable_member_function<T>)
+				{
+					rhs.deserialize(lhs);
+				}
+				else if constexpr(custom_deserializable_static_member_function<T>)
+				{
+					T::deserialize(lhs, rhs);
+				}
+				else if constexpr(custom_deserializable_member_serialize_trait<T>)
+				{
+					T::serialize_trait::deserialize(lhs, rhs);
+				}
+				else if constexpr(custom_deserializable_construct<T>)
+				{
+					rhs = T(from_bit_reader, lhs);
+				}
+			}
+			else
+			{
+				return ::fox::serialize::details::builtin_serialize_traits<T>::deserialize(lhs, rhs);
+			}
+		}
+	}
+
+	/**
+	 * \brief Serializes object into bit_writer
+	 * \tparam T Type of the object to serialize
+	 * \param lhs bit_writer
+	 * \param rhs object to serialize
+	 * \return lhs
+	 */
+	template<serializable T>
+	FOX_SERIALIZE_INLINE bit_writer& operator|(bit_writer& lhs, const T& rhs)
+	{
+		::fox::serialize::details::do_serialize<T>(lhs, rhs);
+		return lhs;
+	}
+
+	/**
+	 * \brief Deserializes object from bit_reader
+	 * \tparam T Type of the object to deserialize
+	 * \param lhs bit_reader
+	 * \param rhs object to deserialize
+	 * \return lhs
+	 */
+	template<deserializable T>
+	FOX_SERIALIZE_INLINE bit_reader& operator|(bit_reader& lhs, T& rhs)
+	{
+		::fox::serialize::details::do_deserialize<T>(lhs, rhs);
+		return lhs;
+	}
+
+	/**
+	 * \brief Serializes object into bit_writer
+	 * \tparam T Type of the object to serialize
+	 * \param lhs bit_writer
+	 * \param rhs object to serialize
+	 */
+	template<serializable T>
+	FOX_SERIALIZE_INLINE void serialize(bit_writer& lhs, const T& rhs)
+	{
+		::fox::serialize::details::do_serialize<T>(lhs, rhs);
+	}
+
+	/**
+	 * \brief Deserializes object from bit_reader
+	 * \tparam T Type of the object to deserialize
+	 * \param lhs bit_reader
+	 * \param rhs object to deserialize
+	 */
+	template<serializable T>
+	FOX_SERIALIZE_INLINE void deserialize(bit_reader& lhs, const T& rhs)
+	{
+		::fox::serialize::details::do_deserialize<T>(lhs, rhs);
+	}
+
+	/**
+	 * \brief Deserializes object from bit_reader
+	 * \tparam T  Type of the object to deserialize
+	 * \param lhs bit_reader
+	 * \return deserialized object
+	 */
+	template<serializable T>
+	[[nodiscard]] FOX_SERIALIZE_INLINE T deserialize(bit_reader& lhs)
+	{
+		if constexpr(::fox::serialize::details::custom_deserializable_construct<T>)
+		{
+			return T(from_bit_reader, lhs);
+		}
+		else
+		{
+			static_assert(std::is_default_constructible_v<T>, "[T] is not default constructible.");
+			T v;
+			::fox::serialize::details::do_deserialize<T>(lhs, v);
+			return v;
+		}
+	}
+
+#pragma endregion traits
+
+#pragma region md_array
+	/**
+	 * \brief Owning multidimensional array, elements are stored contiguously in the row-major order.
+	 * Serialized as its extents followed by its elements, the same as std::mdspan, so N-d data is copied with a single memcpy.
+	 * \tparam T Element type
+	 * \tparam Rank Number of dimensions
+	 * \tparam Allocator Allocator of the elements
+	 */
+	template<class T, std::size_t Rank, class Allocator = std::allocator<T>> requires (Rank > 0 && !std::is_same_v<T, bool>)
+	class md_array
+	{
+	public:
+		using value_type = T;
+		using extents_type = std::array<std::size_t, Rank>;
+
+	private:
+		extents_type extents_{};
+		std::vector<T, Allocator> data_;
+
+	public:
+		/**
+		 * \brief Default constructor. Constructs md_array with all extents equal to zero.
+		 */
+		md_array() = default;
+
+		/**
+		 * \brief Constructs md_array with the given extents.
+		 * \param extents Extent of every dimension
+		 * \param value Value to initialize the elements with
+		 * \param alloc Allocator of the elements
+		 */
+		explicit md_array(const extents_type& extents, const T& value = T{}, const Allocator& alloc = Allocator{})
+			: extents_(extents), data_(element_count(extents), value, alloc) {}
+
+		/**
+		 * \brief Constructs md_array with the given extents and value initialized elements.
+		 * \param extents Extent of every dimension
+		 */
+		template<std::convertible_to<std::size_t>... Extents> requires (sizeof...(Extents) == Rank)
+		explicit md_array(Extents... extents)
+			: md_array(extents_type{ static_cast<std::size_t>(extents)... }) {}
+
+	public:
+		/**
+		 * \brief Number of dimensions.
+		 */
+		[[nodiscard]] static constexpr std::size_t rank() noexcept
+		{
+			return Rank;
+		}
+
+		/**
+		 * \brief Extent of the dimension.
+		 * \param r Index of the dimension
+		 */
+		[[nodiscard]] std::size_t extent(std::size_t r) const noexcept
+		{
+			return extents_[r];
+		}
+
+		/**
+		 * \brief Extents of all dimensions.
+		 */
+		[[nodiscard]] const extents_type& extents() const noexcept
+		{
+			return extents_;
+		}
+
+		/**
+		 * \brief Number of elements, product of the extents.
+		 */
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			return std::size(data_);
+		}
+
+		/**
+		 * \brief Checks if md_array has no elements.
+		 */
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return std::empty(data_);
+		}
+
+		/**
+		 * \brief Pointer to the elements stored in the row-major order.
+		 */
+		[[nodiscard]] T* data() noexcept
+		{
+			return std::data(data_);
+		}
+
+		/**
+		 * \brief Pointer to the elements stored in the row-major order.
+		 */
+		[[nodiscard]] const T* data() const noexcept
+		{
+			return std::data(data_);
+		}
+
+		/**
+		 * \brief Elements in the row-major order.
+		 */
+		[[nodiscard]] std::span<T> flat() noexcept
+		{
+			return data_;
+		}
+
+		/**
+		 * \brief Elements in the row-major order.
+		 */
+		[[nodiscard]] std::span<const T> flat() const noexcept
+		{
+			return data_;
+		}
+
+		/**
+		 * \brief Accesses the element with the given indices.
+		 * \param indices Index in every dimension
+		 */
+		template<std::convertible_to<std::size_t>... Indices> requires (sizeof...(Indices) == Rank)
+		[[nodiscard]] T& operator[](Indices... indices)
+		{
+			return data_[offset({ static_cast<std::size_t>(indices)... })];
+		}
+
+		/**
+		 * \brief Accesses the element with the given indices.
+		 * \param indices Index in every dimension
+		 */
+		template<std::convertible_to<std::size_t>... Indices> requires (sizeof...(Indices) == Rank)
+		[[nodiscard]] const T& operator[](Indices... indices) const
+		{
+			return data_[offset({ static_cast<std::size_t>(indices)... })];
+		}
+
+		/**
+		 * \brief Changes the extents. Elements keep their positions in the flat storage, new elements are value initialized.
+		 * \param extents Extent of every dimension
+		 */
+		void resize(const extents_type& extents)
+		{
+			data_.resize(element_count(extents));
+			extents_ = extents;
+		}
+
+#if defined(__cpp_lib_mdspan)
+		/**
+		 * \brief Returns std::mdspan viewing the elements.
+		 */
+		[[nodiscard]] std::mdspan<T, std::dextents<std::size_t, Rank>> to_mdspan() noexcept
+		{
+			return std::mdspan<T, std::dextents<std::size_t, Rank>>(data(), extents_);
+		}
+
+		/**
+		 * \brief Returns std::mdspan viewing the elements.
+		 */
+		[[nodiscard]] std::mdspan<const T, std::dextents<std::size_t, Rank>> to_mdspan() const noexcept
+		{
+			return std::mdspan<const T, std::dextents<std::size_t, Rank>>(data(), extents_);
+		}
+#endif
+
+		friend bool operator==(const md_array&, const md_array&) = default;
+
+		/**
+		 * \brief Number of elements of md_array with the given extents.
+		 * \throws std::length_error if the number of elements doesn't fit into std::size_t
+		 */
+		[[nodiscard]] static std::size_t element_count(const extents_type& extents)
+		{
+			std::size_t count = 1;
+			for (const std::size_t extent : extents)
+			{
+				if (extent != 0 && count > std::numeric_limits<std::size_t>::max() / extent)
+					throw std::length_error("Extents of the md_array are too large.");
+				count *= extent;
+			}
+			return count;
+		}
+
+	private:
+		[[nodiscard]] std::size_t offset(const extents_type& indices) const noexcept
+		{
+			std::size_t offset = 0;
+			for (std::size_t r = 0; r < Rank; ++r)
+				offset = offset * extents_[r] + indices[r];
+			return offset;
+		}
+	};
+#pragma endregion md_array
+
+	namespace details
+	{
+		// This section provides implementation of default serialization functions for most common cases.
+		// Serializations are divided into sections and then later bunched together, this simplifies SFINAE-compatible implementation later
+
+#pragma region builtin_serialize_const_types
+		// Implementation for const-types
+		template<class T> requires builtin_serializable<T>
+		struct builtin_serialize_traits<const T>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& value)
+			{
+				do_serialize<T>(writer, value);
+			}
+		};
+#pragma endregion builtin_serialize_const_types
+
+#pragma region builtin_serialize_reference_types
+		// Implementation for const-types
+		template<class T> requires builtin_serializable<T>
+		struct builtin_serialize_traits<T&>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& value)
+			{
+				do_serialize<T>(writer, value);
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& value)
+			{
+				do_deserialize<T>(reader, value);
+			}
+		};
+#pragma endregion builtin_serialize_reference_types
+
+#pragma region builtin_serialize_trivially_copyable
+		// Implementation for trivially copyable types
+		template<class T>
+		struct builtin_serialize_trivially_copyable
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& value)
+			{
+				auto ptr = writer.write_bytes<sizeof(T)>();
+				*static_cast<T*>(ptr) = value;
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& value)
+			{
+				auto ptr = reader.read_bytes<sizeof(T)>();
+				value = *static_cast<const T*>(ptr);
+			}
+		};
+
+		template<class T> struct is_optional : std::false_type {};
+
+		template<class T> struct is_optional<std::optional<T>> : std::true_type {};
+
+		template<class Tuple>
+		struct has_optional_element : std::false_type {};
+
+		template<class... Ts>
+		struct has_optional_element<std::tuple<Ts...>> : std::disjunction<is_optional<std::remove_cvref_t<Ts>>...> {};
+
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+		// Aggregate with std::optional members is written with the presence bitmap, even if it's trivially copyable
+		template<class T>
+		concept optional_members_aggregate =
+			!std::ranges::range<T> &&
+			::fox::reflexpr::aggregate<T> &&
+			!std::is_empty_v<T> &&
+			!requires { typename std::tuple_size<T>::type; } &&
+			has_optional_element<decltype(fox::reflexpr::tie(std::declval<T&>()))>::value;
+#else
+		template<class T>
+		concept optional_members_aggregate = false;
+#endif
+
+		template<class T> requires ( !std::ranges::range<T> && std::is_trivially_copyable_v<T> && !ranged_enum<T> && !optional_members_aggregate<T> )
+		struct builtin_serialize_traits<T> : builtin_serialize_trivially_copyable<T> {};
+
+		// True if T is serialized by the trivially copyable trait, which means it's wire representation are its object bytes
+		template<class T>
+		concept bulk_copyable =
+			builtin_serializable<T> &&
+			!custom_serializable<T> &&
+			!custom_deserializable<T> &&
+			std::is_base_of_v<builtin_serialize_trivially_copyable<T>, builtin_serialize_traits<T>>;
+
+		template<class T>
+		struct is_bitset : std::false_type {};
+
+		template<std::size_t Size>
+		struct is_bitset<std::bitset<Size>> : std::true_type {};
+
+		template<class T>
+		struct is_mdspan : std::false_type {};
+
+#if defined(__cpp_lib_mdspan)
+		template<class T, class Extents, class Layout, class Accessor>
+		struct is_mdspan<std::mdspan<T, Extents, Layout, Accessor>> : std::true_type {};
+#endif
+
+		// True if ranges of T are serialized by copying object bytes of their elements.
+		// Trivially copyable ranges (e.g. std::string_view) are views, their object bytes are meaningless.
+		template<class T>
+		concept memcpy_compatible_element =
+			!std::ranges::range<T> &&
+			std::is_trivially_copyable_v<T> &&
+			!custom_serializable<T> &&
+			!custom_deserializable<T> &&
+			!is_bitset<T>::value &&
+			!is_mdspan<T>::value &&
+			!ranged_enum<T> &&
+			!optional_members_aggregate<T>;
+#pragma endregion builtin_serialize_trivially_copyable
+
+#pragma region builtin_enums
+		// Enums with enum_range are written as the offset from min, so the range check on read is a single unsigned comparison
+		template<ranged_enum T>
+		struct builtin_serialize_traits<T>
+		{
+			using underlying_type = std::make_unsigned_t<std::underlying_type_t<T>>;
+
+			static constexpr underlying_type min = static_cast<underlying_type>(std::to_underlying(static_cast<T>(enum_range<T>::min)));
+			static constexpr underlying_type range = static_cast<underlying_type>(
+				static_cast<underlying_type>(std::to_underlying(static_cast<T>(enum_range<T>::max))) - min);
+
+			static_assert(
+				static_cast<std::underlying_type_t<T>>(enum_range<T>::min) <= static_cast<std::underlying_type_t<T>>(enum_range<T>::max),
+				"enum_range<T>::min can't be greater than enum_range<T>::max."
+			);
+
+			// Smallest unsigned integer covering the range
+			using wire_type =
+				std::conditional_t<range <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+				std::conditional_t<range <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+				std::conditional_t<range <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t, std::uint64_t>>>;
+
+			[[nodiscard]] static constexpr wire_type encode(T value)
+			{
+				const auto offset = static_cast<underlying_type>(static_cast<underlying_type>(std::to_underlying(value)) - min);
+				if (offset > range) [[unlikely]]
+					throw std::out_of_range(std::format("Enum value {} is outside of its enum_range.", std::to_underlying(value)));
+
+				return static_cast<wire_type>(offset);
+			}
+
+			[[nodiscard]] static constexpr T decode(wire_type offset)
+			{
+				if (offset > range) [[unlikely]]
+					throw std::out_of_range(std::format("Enum offset {} is outside of its enum_range.", offset));
+
+				return static_cast<T>(static_cast<underlying_type>(min + offset));
+			}
+
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& value)
+			{
+				writer | encode(value);
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& value)
+			{
+				wire_type offset{};
+				reader | offset;
+				value = decode(offset);
+			}
+		};
+#pragma endregion builtin_enums
+
+#pragma region builtin_coalesced_members
+		// Serializes a list of members, coalescing consecutive bulk_copyable members into a single write / read.
+		// Wire format is identical to serializing every member separately - padding between members is never written.
+		template<class... Ts>
+		struct coalesced_members
+		{
+			static constexpr std::size_t size = sizeof...(Ts);
+
+			static constexpr std::array<bool, size> bulk = { bulk_copyable<std::remove_cvref_t<Ts>>... };
+
+			static constexpr std::array<std::size_t, size> sizes = { sizeof(std::remove_cvref_t<Ts>)... };
+
+			struct run
+			{
+				std::size_t first;
+				std::size_t last;
+				bool bulk;
+			};
+
+			static constexpr std::size_t num_runs = []() FOX_SERIALIZE_CONSTEXPR_LAMBDA
+			{
+				std::size_t n = 0;
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					if (i == 0 || !bulk[i] || !bulk[i - 1])
+						++n;
+				}
+				return n;
+			}();
+
+			static constexpr std::array<run, num_runs> runs = []() FOX_SERIALIZE_CONSTEXPR_LAMBDA
+			{
+				std::array<run, num_runs> out{};
+				std::size_t n = 0;
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					if (i == 0 || !bulk[i] || !bulk[i - 1])
+						out[n++] = run{ i, i + 1, bulk[i] };
+					else
+						out[n - 1].last = i + 1;
+				}
+				return out;
+			}();
+
+			// Offset of the member within the bytes of its run
+			static constexpr std::array<std::size_t, size> run_offsets = []() FOX_SERIALIZE_CONSTEXPR_LAMBDA
+			{
+				std::array<std::size_t, size> out{};
+				for (const run& r : runs)
+				{
+					std::size_t offset = 0;
+					for (std::size_t i = r.first; i < r.last; ++i)
+					{
+						out[i] = offset;
+						offset += sizes[i];
+					}
+				}
+				return out;
+			}();
+
+			template<std::size_t R>
+			static constexpr std::size_t run_size = run_offsets[runs[R].last - 1] + sizes[runs[R].last - 1];
+
+			// Get is invoked with std::integral_constant<std::size_t, I> and returns the reference to the I-th member
+			template<class Get>
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, Get&& get)
+			{
+				[&]<std::size_t... R>(std::index_sequence<R...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
+				{
+					(serialize_run<R>(writer, get), ...);
+				}(std::make_index_sequence<num_runs>{});
+			}
+
+			template<class Get>
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, Get&& get)
+			{
+				[&]<std::size_t... R>(std::index_sequence<R...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
+				{
+					(deserialize_run<R>(reader, get), ...);
+				}(std::make_index_sequence<num_runs>{});
+			}
+
+			// Padding between members is never written, so the size is the sum of the member sizes
+			template<class Get>
+			static std::size_t serialized_size(bit_writer& counter, Get&& get)
+			{
+				return [&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+				{
+					return (static_cast<std::size_t>(0) + ... +
+						::fox::serialize::details::dynamic_serialized_size<std::remove_cvref_t<Ts>>(get(std::integral_constant<std::size_t, Idx>{}), counter));
+				}(std::index_sequence_for<Ts...>{});
+			}
+
+		private:
+			template<std::size_t Idx>
+			using member_t = std::tuple_element_t<Idx, std::tuple<Ts...>>;
+
+			// Checks if members of the run are laid out in memory exactly as on the wire, if so run can be copied at once.
+			// Offsets of aggregate members are constant, so for aggregates this check is folded by the compiler.
+			template<std::size_t R, class Get>
+			FOX_SERIALIZE_INLINE static bool is_run_contiguous(Get& get)
+			{
+				return [&]<std::size_t... Idx>(std::index_sequence<Idx...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
+				{
+					const auto first = reinterpret_cast<std::uintptr_t>(std::addressof(get(std::integral_constant<std::size_t, runs[R].first>{})));
+					return ((reinterpret_cast<std::uintptr_t>(std::addressof(get(std::integral_constant<std::size_t, runs[R].first + Idx>{}))) ==
+						first + run_offsets[runs[R].first + Idx]) && ...);
+				}(std::make_index_sequence<runs[R].last - runs[R].first>{});
+			}
+
+			template<std::size_t R, class Get>
+			FOX_SERIALIZE_INLINE static void serialize_run(bit_writer& writer, Get& get)
+			{
+				constexpr run r = runs[R];
+				if constexpr (r.bulk)
+				{
+					auto dest = static_cast<std::byte*>(writer.write_bytes<run_size<R>>());
+
+					if (is_run_contiguous<R>(get))
+					{
+						(void)std::memcpy(dest, std::addressof(get(std::integral_constant<std::size_t, r.first>{})), run_size<R>);
+						return;
+					}
+
+					[&]<std::size_t... Idx>(std::index_sequence<Idx...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
+					{
+						((void)std::memcpy(
+							dest + run_offsets[r.first + Idx], 
+							std::addressof(get(std::integral_constant<std::size_t, r.first + Idx>{})), 
+							sizes[r.first + Idx]), ...);
+					}(std::make_index_sequence<r.last - r.first>{});
+				}
+				else
+				{
+					::fox::serialize::details::do_serialize<member_t<r.first>>(writer, get(std::integral_constant<std::size_t, r.first>{}));
+				}
+			}
+
+			template<std::size_t R, class Get>
+			FOX_SERIALIZE_INLINE static void deserialize_run(bit_reader& reader, Get& get)
+			{
+				constexpr run r = runs[R];
+				if constexpr (r.bulk)
+				{
+					auto src = static_cast<const std::byte*>(reader.read_bytes<run_size<R>>());
+
+					if (is_run_contiguous<R>(get))
+					{
+						(void)std::memcpy(static_cast<void*>(std::addressof(get(std::integral_constant<std::size_t, r.first>{}))), src, run_size<R>);
+						return;
+					}
+
+					[&]<std::size_t... Idx>(std::index_sequence<Idx...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
+					{
+						((void)std::memcpy(
+							static_cast<void*>(std::addressof(get(std::integral_constant<std::size_t, r.first + Idx>{}))),
+							src + run_offsets[r.first + Idx], 
+							sizes[r.first + Idx]), ...);
+					}(std::make_index_sequence<r.last - r.first>{});
+				}
+				else
+				{
+					::fox::serialize::details::do_deserialize<member_t<r.first>>(reader, get(std::integral_constant<std::size_t, r.first>{}));
+				}
+			}
+		};
+
+		// Calls f with the index of every set bit
+		template<std::size_t Words, class F>
+		FOX_SERIALIZE_INLINE void for_each_set_bit(const std::array<std::uint64_t, Words>& bits, F&& f)
+		{
+			for (std::size_t w = 0; w < Words; ++w)
+			{
+				for (std::uint64_t word = bits[w]; word != 0; word &= word - 1)
+					f(w * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+			}
+		}
+
+		// Serializes a list of members, writing engaged states of all std::optional members as a single presence bitmap.
+		// Wire format: bitmap (bit J % 8 of byte J / 8 for the J-th optional member), other members coalesced, values of engaged optional members.
+		// Without optional members wire format is identical to coalesced_members.
+		template<class... Ts>
+		struct presence_members
+		{
+			static constexpr std::size_t size = sizeof...(Ts);
+
+			static constexpr std::array<bool, size> optional = { is_optional<std::remove_cvref_t<Ts>>::value... };
+
+			static constexpr std::size_t optional_count = static_cast<std::size_t>(std::ranges::count(optional, true));
+
+			static constexpr std::size_t bitmap_size = (optional_count + 7) / 8;
+
+			// Indices of optional members
+			static constexpr auto optional_indices = []() FOX_SERIALIZE_CONSTEXPR_LAMBDA
+			{
+				std::array<std::size_t, optional_count> out{};
+				for (std::size_t i = 0, n = 0; i < size; ++i)
+				{
+					if (optional[i])
+						out[n++] = i;
+				}
+				return out;
+			}();
+
+			// Indices of other members
+			static constexpr auto value_indices = []() FOX_SERIALIZE_CONSTEXPR_LAMBDA
+			{
+				std::array<std::size_t, size - optional_count> out{};
+				for (std::size_t i = 0, n = 0; i < size; ++i)
+				{
+					if (!optional[i])
+						out[n++] = i;
+				}
+				return out;
+			}();
+
+		private:
+			static constexpr std::size_t words = (optional_count + 63) / 64;
+
+			using bitmap = std::array<std::uint64_t, words>;
+
+			template<std::size_t... Is>
+			static auto select_values(std::index_sequence<Is...>) -> coalesced_members<std::tuple_element_t<value_indices[Is], std::tuple<Ts...>>...>;
+
+			using value_members = decltype(select_values(std::make_index_sequence<size - optional_count>{}));
+
+			template<std::size_t J>
+			using optional_t = std::remove_cvref_t<std::tuple_element_t<optional_indices[J], std::tuple<Ts...>>>;
+
+		public:
+			// Get is invoked with std::integral_constant<std::size_t, I> and returns the reference to the I-th member
+			template<class Get>
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, Get&& get)
+			{
+				if constexpr (optional_count == 0)
+				{
+					coalesced_members<Ts...>::serialize(writer, get);
+				}
+				else
+				{
+					using write_function = void(*)(bit_writer&, std::remove_reference_t<Get>&);
+					static constexpr auto writes = []<std::size_t... J>(std::index_sequence<J...>)
+					{
+						return std::array<write_function, optional_count>{ &serialize_optional<J, std::remove_reference_t<Get>>... };
+					}(std::make_index_sequence<optional_count>{});
+
+					bitmap present{};
+					[&]<std::size_t... J>(std::index_sequence<J...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
+					{
+						((present[J / 64] |= static_cast<std::uint64_t>(get(std::integral_constant<std::size_t, optional_indices[J]>{}).has_value()) << (J % 64)), ...);
+					}(std::make_index_sequence<optional_count>{});
+
+					auto dest = static_cast<std::byte*>(writer.write_bytes<bitmap_size>());
+					for (std::size_t i = 0; i < bitmap_size; ++i)
+						dest[i] = static_cast<std::byte>(present[i / 8] >> (8 * (i % 8)));
+
+					value_members::serialize(writer, [&]<std::size_t I>(std::integral_constant<std::size_t, I>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+					{
+						return get(std::integral_constant<std::size_t, value_indices[I]>{});
+					});
+
+					for_each_set_bit(present, [&](std::size_t j) { writes[j](writer, get); });
+				}
+			}
+
+			template<class Get>
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, Get&& get)
+			{
+				if constexpr (optional_count == 0)
+				{
+					coalesced_members<Ts...>::deserialize(reader, get);
+				}
+				else
+				{
+					using read_function = void(*)(bit_reader&, std::remove_reference_t<Get>&);
+					static constexpr auto reads = []<std::size_t... J>(std::index_sequence<J...>)
+					{
+						return std::array<read_function, optional_count>{ &deserialize_optional<J, std::remove_reference_t<Get>>... };
+					}(std::make_index_sequence<optional_count>{});
+
+					static constexpr auto resets = []<std::size_t... J>(std::index_sequence<J...>)
+					{
+						return std::array<read_function, optional_count>{ &reset_optional<J, std::remove_reference_t<Get>>... };
+					}(std::make_index_sequence<optional_count>{});
+
+					bitmap present{};
+					auto src = static_cast<const std::byte*>(reader.read_bytes<bitmap_size>());
+					for (std::size_t i = 0; i < bitmap_size; ++i)
+						present[i / 8] |= static_cast<std::uint64_t>(src[i]) << (8 * (i % 8));
+
+					bitmap absent{};
+					for (std::size_t w = 0; w < words; ++w)
+					{
+						const std::size_t bits = std::min<std::size_t>(optional_count - w * 64, 64);
+						const std::uint64_t mask = bits == 64 ? ~std::uint64_t{} : (std::uint64_t{ 1 } << bits) - 1;
+						if ((present[w] & ~mask) != 0)
+							throw std::invalid_argument("Invalid presence bitmap.");
+
+						absent[w] = ~present[w] & mask;
+					}
+
+					value_members::deserialize(reader, [&]<std::size_t I>(std::integral_constant<std::size_t, I>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+					{
+						return get(std::integral_constant<std::size_t, value_indices[I]>{});
+					});
+
+					for_each_set_bit(absent, [&](std::size_t j) { resets[j](reader, get); });
+					for_each_set_bit(present, [&](std::size_t j) { reads[j](reader, get); });
+				}
+			}
+
+			template<class Get>
+			static std::size_t serialized_size(bit_writer& counter, Get&& get)
+			{
+				if constexpr (optional_count == 0)
+				{
+					return coalesced_members<Ts...>::serialized_size(counter, get);
+				}
+				else
+				{
+					const std::size_t values = value_members::serialized_size(counter, [&]<std::size_t I>(std::integral_constant<std::size_t, I>) -> decltype(auto)
+					{
+						return get(std::integral_constant<std::size_t, value_indices[I]>{});
+					});
+
+					return bitmap_size + values + [&]<std::size_t... J>(std::index_sequence<J...>)
+					{
+						return (static_cast<std::size_t>(0) + ... + optional_value_size<J>(counter, get));
+					}(std::make_index_sequence<optional_count>{});
+				}
+			}
+
+		private:
+			template<std::size_t J, class Get>
+			static std::size_t optional_value_size(bit_writer& counter, Get& get)
+			{
+				using value_type = typename optional_t<J>::value_type;
+				const auto& optional = get(std::integral_constant<std::size_t, optional_indices[J]>{});
+				return optional.has_value() ? ::fox::serialize::details::dynamic_serialized_size<value_type>(*optional, counter) : 0;
+			}
+
+			template<std::size_t J, class Get>
+			static void serialize_optional(bit_writer& writer, Get& get)
+			{
+				using value_type = typename optional_t<J>::value_type;
+				::fox::serialize::details::do_serialize<value_type>(writer, *get(std::integral_constant<std::size_t, optional_indices[J]>{}));
+			}
+
+			template<std::size_t J, class Get>
+			static void deserialize_optional(bit_reader& reader, Get& get)
+			{
+				using value_type = typename optional_t<J>::value_type;
+				auto& optional = get(std::integral_constant<std::size_t, optional_indices[J]>{});
+				if constexpr (custom_deserializable_construct<value_type>)
+				{
+					// Construct with reader if possible
+					optional.emplace(from_bit_reader, reader);
+				}
+				else
+				{
+					::fox::serialize::details::do_deserialize<value_type>(reader, optional.emplace());
+				}
+			}
+
+			template<std::size_t J, class Get>
+			static void reset_optional(bit_reader&, Get& get)
+			{
+				get(std::integral_constant<std::size_t, optional_indices[J]>{}).reset();
+			}
+		};
+
+		template<class Tuple>
+		struct presence_members_of;
+
+		template<class... Ts>
+		struct presence_members_of<std::tuple<Ts...>>
+		{
+			using type = presence_members<std::remove_cvref_t<Ts>...>;
+		};
+#pragma endregion builtin_coalesced_members
+
+#pragma region builtin_serialize_ranges
+		template<class T>
+		struct is_array : std::false_type {};
+
+		template<class T, std::size_t Size>
+		struct is_array<std::array<T, Size>> : std::true_type {};
+
+		// Helper traits for std::ranges::to - concept 
+		template<class Container>
+		constexpr bool reservable_container =
+			std::ranges::sized_range<Container> &&
+		requires(Container& c, std::ranges::range_size_t<Container> n)
+		{
+			c.reserve(n);
+			{ c.capacity() } -> std::same_as<decltype(n)>;
+			{ c.max_size() } -> std::same_as<decltype(n)>;
+		};
+
+		template<class Container, class Ref>
+		constexpr bool container_insertable =
+			requires(Container& c, Ref&& ref)
+		{
+			requires(requires {c.push_back(std::forward<Ref>(ref)); } ||
+				requires {c.insert(c.end(), std::forward<Ref>(ref)); });
+		};
+
+		// std::ranges::to concept, std::ranges::to isn't SFINAE compatible - it uses static_assert
+		template<class C, std::ranges::input_range R, class... Args>
+		constexpr bool is_ranges_to_convertible =
+			// Mandates: C is a cv-unqualified class type
+			std::is_const_v<C> == false &&
+			std::is_volatile_v<C> == false &&
+			std::is_class_v<C> == true &&
+			(
+			( 
+				(std::ranges::input_range<C> == false || std::convertible_to<std::ranges::range_reference_t<R>, std::ranges::range_value_t<R>> == true) &&
+				(
+					std::constructible_from<C, R, Args...> == true ||
+					std::constructible_from<C, std::from_range_t, R, Args...> == true ||
+					(
+						std::ranges::common_range<R> && 
+						std::derived_from<typename std::iterator_traits<std::ranges::iterator_t<R>>::iterator_category, std::input_iterator_tag> &&
+						std::constructible_from<C, std::ranges::iterator_t<R>, std::ranges::sentinel_t<R>, Args...> == true
+					) ||
+					(
+						std::constructible_from<C, Args...> == true &&
+						container_insertable<C, std::ranges::range_reference_t<R>> == true
+					)
+				)
+			) ||
+			( std::ranges::input_range<std::ranges::range_reference_t<R>> && std::convertible_to<std::ranges::range_reference_t<R>, C> )
+			);
+
+#pragma region tuple_like
+		template<template <std::size_t, class> class Trait, class T, class>
+		struct indexed_conjunction_proxy : std::false_type {};
+
+		template<template <std::size_t, class> class Trait, class T, std::size_t... Idx>
+		struct indexed_conjunction_proxy<Trait, T, std::index_sequence<Idx...>> : std::conjunction<Trait<Idx, T>...> {};
+
+		template<template <std::size_t, class> class Trait, class T, std::size_t Size>
+		struct indexed_conjunction : indexed_conjunction_proxy < Trait, T, std::make_index_sequence<Size>> {};
+
+		template<template <std::size_t, class> class Trait, class T>
+		struct indexed_conjunction<Trait, T, static_cast<std::size_t>(0)> : std::true_type {};
+
+		template<std::size_t Idx, class T>
+		constexpr bool has_tuple_element_v =
+			requires(T tuple)
+		{
+			typename std::tuple_element_t<Idx, std::remove_cvref_t<T>>;
+			{ std::get<Idx>(tuple) } -> std::convertible_to<const std::tuple_element_t<Idx, T>&>;
+		};
+
+		template<std::size_t Idx, class T>
+		struct has_tuple_element : std::bool_constant<has_tuple_element_v<Idx, T>> {};
+
+		template<class T>
+		constexpr bool is_tuple_like_v =
+			std::is_reference_v<T> == false &&
+			requires
+		{
+			typename std::tuple_size<T>::type;
+			requires std::derived_from<std::tuple_size<T>, std::integral_constant<std::size_t, std::tuple_size_v<T>>>;
+			requires indexed_conjunction<has_tuple_element, T, std::tuple_size_v<T>>::value;
+		};
+
+		template<class T>
+		concept tuple_like = is_tuple_like_v<T>;
+#pragma endregion tuple_like
+
+		template<class T>
+		constexpr std::optional<std::size_t> static_serialized_size() noexcept;
+
+		// Minimal number of bytes T takes in the data, 0 if unknown
+		template<class T>
+		constexpr std::size_t min_serialized_size() noexcept;
+
+		// Tracks the nesting depth of the reader, refer to decode_limits::max_depth
+		class nesting_guard
+		{
+			bit_reader& reader_;
+
+		public:
+			explicit nesting_guard(bit_reader& reader)
+				: reader_(reader)
+			{
+				reader_.enter();
+			}
+
+			nesting_guard(const nesting_guard&) = delete;
+			nesting_guard& operator=(const nesting_guard&) = delete;
+
+			~nesting_guard() noexcept
+			{
+				reader_.leave();
+			}
+		};
+
+		// Pads the data so elements of T stored as object bytes are aligned, refer to bit_writer::set_alignment
+		template<class T>
+		FOX_SERIALIZE_INLINE void write_elements_padding(bit_writer& writer)
+		{
+			if (writer.alignment() != 0) [[unlikely]]
+				writer.align(std::max(writer.alignment(), alignof(T)));
+		}
+
+		template<class T>
+		FOX_SERIALIZE_INLINE void read_elements_padding(bit_reader& reader)
+		{
+			if (reader.alignment() != 0) [[unlikely]]
+				reader.align(std::max(reader.alignment(), alignof(T)));
+		}
+
+#pragma region segmented_ranges
+		// Customization point - range providing segments(), a range of contiguous ranges covering its elements in order,
+		// e.g. ring buffer or chunked arena
+		template<class T>
+		concept custom_segmented_range = requires(T& range)
+		{
+			{ range.segments() } -> std::ranges::input_range;
+			requires std::ranges::contiguous_range<std::remove_cvref_t<std::ranges::range_reference_t<decltype(range.segments())>>>;
+		};
+
+		// Random access range of lvalue elements stored in blocks, e.g. std::deque. Blocks are found by comparing element addresses
+		template<class T>
+		concept block_segmented_range =
+			std::ranges::random_access_range<T> &&
+			std::is_lvalue_reference_v<std::ranges::range_reference_t<T>> &&
+			std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<T>>, std::ranges::range_value_t<T>>;
+
+		// Range which isn't contiguous, but consists of contiguous segments
+		template<class T>
+		concept segmented_range =
+			std::ranges::sized_range<T> &&
+			!std::ranges::contiguous_range<T> &&
+			(custom_segmented_range<T> || block_segmented_range<T>);
+
+		// Calls f(pointer, count) for every contiguous segment of the range in order
+		template<segmented_range T, class F>
+		FOX_SERIALIZE_INLINE void for_each_segment(T& range, F&& f)
+		{
+			if constexpr (custom_segmented_range<T>)
+			{
+				for (auto&& segment : range.segments())
+				{
+					if (std::ranges::size(segment) != 0)
+						f(std::ranges::data(segment), static_cast<std::size_t>(std::ranges::size(segment)));
+				}
+			}
+			else
+			{
+				auto it = std::ranges::begin(range);
+				const auto end = std::ranges::end(range);
+				while (it != end)
+				{
+					// Segment grows while the next element directly follows the previous one in memory
+					const auto first = std::addressof(*it);
+					const std::ptrdiff_t remaining = end - it;
+					std::ptrdiff_t count = 1;
+					while (count < remaining && std::addressof(it[count]) == first + count)
+						++count;
+
+					f(first, static_cast<std::size_t>(count));
+					it += count;
+				}
+			}
+		}
+
+		// Writes object bytes of the segments, range has to hold size elements
+		template<segmented_range T>
+		FOX_SERIALIZE_INLINE void write_segments(bit_writer& writer, const T& range, std::size_t size)
+		{
+			using value_type = std::ranges::range_value_t<T>;
+
+			std::size_t offset = 0;
+			for_each_segment(range, [&](const value_type* segment, std::size_t count)
+			{
+				if (count > size - offset)
+					throw std::out_of_range("Segments of the range hold more elements than its size.");
+
+				writer.write_bytes(static_cast<const void*>(segment), sizeof(value_type) * count);
+				offset += count;
+			});
+
+			if (offset != size)
+				throw std::out_of_range("Segments of the range hold less elements than its size.");
+		}
+
+		// Copies object bytes from src into the segments, range has to hold size elements
+		template<segmented_range T>
+		FOX_SERIALIZE_INLINE void copy_into_segments(T& range, const std::byte* src, std::size_t size)
+		{
+			using value_type = std::ranges::range_value_t<T>;
+
+			std::size_t offset = 0;
+			for_each_segment(range, [&](value_type* segment, std::size_t count)
+			{
+				if (count > size - offset)
+					throw std::out_of_range("Segments of the range hold more elements than its size.");
+
+				(void)std::memcpy(static_cast<void*>(segment), src + offset * sizeof(value_type), sizeof(value_type) * count);
+				offset += count;
+			});
+
+			if (offset != size)
+				throw std::out_of_range("Segments of the range hold less elements than its size.");
+		}
+#pragma endregion segmented_ranges
+
+		template<class T>
+		struct tuple_like_remove_const
+		{
+			using type = T;
+		};
+
+		template<template<class...> class Tuple, class... Ts> requires
+			is_tuple_like_v<Tuple<Ts...>> && std::is_constructible_v<Tuple<Ts...>, Tuple<std::remove_const_t<Ts>...>>
+		struct tuple_like_remove_const<Tuple<Ts...>>
+		{
+			using type = Tuple<std::remove_const_t<Ts>...>;
+		};
+
+		// Ranges store memcpy compatible elements as object bytes, so they can be read with a single memcpy
+		template<class T>
+		FOX_SERIALIZE_INLINE void write_range_element(bit_writer& writer, const T& e)
+		{
+			if constexpr (memcpy_compatible_element<T>)
+				writer.write_bytes(static_cast<const void*>(std::addressof(e)), sizeof(T));
+			else
+				writer | e;
+		}
+
+		// Writes the elements in a single pass, the length placeholder is patched once they are counted
+		template<class Range>
+		FOX_SERIALIZE_INLINE void write_single_pass_range(bit_writer& writer, Range&& range)
+		{
+			using value_type = std::ranges::range_value_t<Range>;
+
+			const std::size_t position = writer.write_placeholder(sizeof(std::size_t));
+			if constexpr (memcpy_compatible_element<value_type>)
+				write_elements_padding<value_type>(writer);
+
+			std::size_t count = 0;
+			for (auto&& e : range)
+			{
+				write_range_element<value_type>(writer, e);
+				++count;
+			}
+			writer.patch(position, count);
+		}
+
+		// Elements are references to or values of the value type, not proxies like std::vector<bool>::reference
+		template<class Range>
+		concept element_reference_range = std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<Range>>, std::ranges::range_value_t<Range>>;
+
+		template<std::ranges::range T>
+		struct builtin_serialize_traits<T>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& range) requires
+				serializable<std::ranges::range_value_t<T>>
+			{
+				if constexpr (std::ranges::sized_range<const T>)
+				{
+					serialize_sized(writer, range);
+				}
+				else // Size isn't known upfront (e.g. std::forward_list), it's patched after writing the elements
+				{
+					::fox::serialize::details::write_single_pass_range(writer, range);
+				}
+			}
+
+		private:
+			FOX_SERIALIZE_INLINE static void serialize_sized(bit_writer& writer, const T& range)
+			{
+				using value_type = std::ranges::range_value_t<T>;
+
+				const std::size_t range_size = std::size(range);
+				writer | range_size;
+
+				if constexpr (::fox::serialize::details::memcpy_compatible_element<value_type>)
+					::fox::serialize::details::write_elements_padding<value_type>(writer);
+
+				// Check if we can memcpy the range
+				constexpr bool memcpy_compatible =
+					std::ranges::contiguous_range<T> &&
+					::fox::serialize::details::memcpy_compatible_element<value_type>;
+
+				if constexpr (memcpy_compatible)
+				{
+					writer.write_bytes(static_cast<const void*>(std::data(range)), sizeof(value_type) * range_size);
+				}
+				else if constexpr (::fox::serialize::details::segmented_range<const T> && ::fox::serialize::details::bulk_copyable<value_type>)
+				{
+					// Elements are written as object bytes either way, so we copy segment by segment
+					::fox::serialize::details::write_segments(writer, range, range_size);
+				}
+				else // We iterate over the range
+				{
+					for (auto&& e : range)
+					{
+						::fox::serialize::details::write_range_element<value_type>(writer, e);
+					}
+				}
+			}
+
+		public:
+			static std::size_t serialized_size(const T& range, bit_writer& counter) requires
+				serializable<std::ranges::range_value_t<T>>
+			{
+				using value_type = std::ranges::range_value_t<T>;
+
+				// Memcpy compatible elements are written as object bytes by every range
+				const auto range_size = static_cast<std::size_t>(std::ranges::distance(range));
+				if constexpr (::fox::serialize::details::memcpy_compatible_element<value_type>)
+				{
+					return sizeof(std::size_t) + sizeof(value_type) * range_size;
+				}
+				else if constexpr (constexpr auto element = ::fox::serialize::details::static_serialized_size<value_type>(); element.has_value())
+				{
+					return sizeof(std::size_t) + *element * range_size;
+				}
+				else
+				{
+					std::size_t size = sizeof(std::size_t);
+					for (auto&& e : range)
+						size += ::fox::serialize::details::dynamic_serialized_size<value_type>(e, counter);
+					return size;
+				}
+			}
+
+			static constexpr bool is_deserializable =
+				!std::ranges::borrowed_range<T> &&
+				deserializable<tuple_like_remove_const<std::ranges::range_value_t<T>>> && // In case we are tuple with const member, remove const if constructible from it
+				(::fox::serialize::details::is_array<T>::value || 
+					(
+						::fox::serialize::details::is_ranges_to_convertible<T, std::span<const std::ranges::range_value_t<T>>> &&
+					(std::is_default_constructible_v<std::ranges::range_value_t<T>> || details::custom_deserializable_construct<T>)));
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& value) requires is_deserializable
+				
+			{
+				using value_type = typename tuple_like_remove_const<std::ranges::range_value_t<T>>::type;
+				using const_value_type = std::add_const_t<std::ranges::range_value_t<T>>;
+
+				const nesting_guard nesting(reader);
+
+				std::size_t size{};
+				reader | size;
+
+				if constexpr (!::fox::serialize::details::is_array<T>::value)
+					reader.charge(size, sizeof(value_type), ::fox::serialize::details::min_serialized_size<value_type>());
+
+				if constexpr (::fox::serialize::details::memcpy_compatible_element<value_type>)
+					::fox::serialize::details::read_elements_padding<value_type>(reader);
+
+				// Check if we can memcpy the range
+				constexpr bool memcpy_compatible = ::fox::serialize::details::memcpy_compatible_element<value_type>;
+
+				if constexpr (::fox::serialize::details::segmented_range<T> && ::fox::serialize::details::bulk_copyable<value_type> &&
+					requires { value.resize(size); })
+				{
+					auto src = static_cast<const std::byte*>(reader.read_bytes(sizeof(value_type) * size));
+					value.resize(size);
+					::fox::serialize::details::copy_into_segments(value, src, size);
+				}
+				else if constexpr (::fox::serialize::details::is_ranges_to_convertible<T, std::span<const value_type>> && memcpy_compatible)
+				{
+					const value_type* ptr = static_cast<const value_type*>(reader.read_bytes(sizeof(value_type) * size));
+					value = std::span<const_value_type >{ ptr, size } | std::ranges::to<T>();
+				}
+				else if constexpr (::fox::serialize::details::is_array<T>::value)
+				{
+					if (size != std::size(value))
+					{
+						throw std::out_of_range(std::format("Trying to read ranges ({} elements) of a different size than the array ({} elements).",
+							size, std::size(value))
+						);
+					}
+
+					// Memcpy array
+					if constexpr (memcpy_compatible)
+					{
+						auto ptr = static_cast<const value_type*>(reader.read_bytes(sizeof(value_type) * size));
+						std::memcpy(static_cast<void*>(std::data(value)), static_cast<const void*>(ptr), sizeof(value_type) * size);
+					}
+					else // Or iterate over elements and serialize them
+					{
+						for (auto&& e : value)
+						{
+							reader | e;
+						}
+					}
+				}
+				else // Iterate over elements, serialize them and then convert them into the range
+				{
+					value = std::views::iota(static_cast<std::size_t>(0), size)
+						| std::views::transform([&](auto) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> value_type
+						{
+							if constexpr(custom_deserializable_construct<value_type>)
+							{
+								// Construct with reader if possible
+								value_type v(from_bit_reader, reader);
+								return v;
+							}
+							else
+							{
+								value_type v;
+								reader | v;
+								return v;
+							}
+						})
+						| std::views::as_rvalue
+						| std::ranges::to<T>();
+				}
+			}
+		};
+
+#pragma endregion builtin_serialize_ranges
+
+#pragma region builtin_strings
+		template<class T>
+		struct is_char_string : std::false_type {};
+
+		template<class Alloc>
+		struct is_char_string<std::basic_string<char, std::char_traits<char>, Alloc>> : std::true_type {};
+
+		// Without the dictionary strings are written like any other range, with it they are a varint tag:
+		// 0 followed by varint length and characters of the new string, or id + 1 of the string already in the dictionary.
+		inline void write_string(bit_writer& writer, std::string_view str)
+		{
+			if (string_dictionary* dictionary = writer.get_string_dictionary())
+			{
+				if (const auto id = dictionary->find(str))
+				{
+					write_varint(writer, *id + 1);
+					return;
+				}
+
+				(void)dictionary->insert(str);
+				write_varint(writer, 0);
+				write_varint(writer, std::size(str));
+			}
+			else
+			{
+				writer | std::size(str);
+			}
+
+			if (!std::empty(str))
+				writer.write_bytes(std::data(str), std::size(str));
+		}
+
+		// Returned view points either into the dictionary or into the reader
+		[[nodiscard]] inline std::string_view read_string(bit_reader& reader)
+		{
+			if (string_dictionary* dictionary = reader.get_string_dictionary())
+			{
+				const std::uint64_t tag = read_varint(reader);
+				if (tag != 0)
+					return dictionary->at(static_cast<std::size_t>(tag - 1));
+
+				const auto size = static_cast<std::size_t>(read_varint(reader));
+				return dictionary->insert({ static_cast<const char*>(reader.read_bytes(size)), size });
+			}
+
+			std::size_t size{};
+			reader | size;
+			return { static_cast<const char*>(reader.read_bytes(size)), size };
+		}
+
+		template<class Alloc>
+		struct builtin_serialize_traits<std::basic_string<char, std::char_traits<char>, Alloc>>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::basic_string<char, std::char_traits<char>, Alloc>& value)
+			{
+				write_string(writer, value);
+			}
+
+			// The counting bit_writer has no string_dictionary
+			static std::size_t serialized_size(const std::basic_string<char, std::char_traits<char>, Alloc>& value, bit_writer&)
+			{
+				return sizeof(std::size_t) + std::size(value);
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::basic_string<char, std::char_traits<char>, Alloc>& value)
+			{
+				const std::string_view str = read_string(reader);
+				reader.charge(std::size(str), sizeof(char));
+				value.assign(str);
+			}
+		};
+
+		// Deserialized std::string_view points into the string_dictionary of the reader. Reader without the dictionary throws,
+		// a view into the reader would dangle once the reader is appended to, compacted or cleared.
+		template<>
+		struct builtin_serialize_traits<std::string_view>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::string_view& value)
+			{
+				write_string(writer, value);
+			}
+
+			static std::size_t serialized_size(const std::string_view& value, bit_writer&)
+			{
+				return sizeof(std::size_t) + std::size(value);
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::string_view& value)
+			{
+				if (reader.get_string_dictionary() == nullptr)
+					throw std::logic_error("std::string_view can only be read by bit_reader with a string_dictionary.");
+
+				value = read_string(reader);
+			}
+		};
+#pragma endregion builtin_strings
+
+#pragma region builtin_bits
+		template<class T>
+		struct is_vector_bool : std::false_type {};
+
+		template<class Alloc>
+		struct is_vector_bool<std::vector<bool, Alloc>> : std::true_type {};
+
+		// Number of 64 bit words holding bit_count bits
+		constexpr std::size_t packed_bits_words(std::size_t bit_count) noexcept
+		{
+			return bit_count / 64 + (bit_count % 64 != 0 ? 1 : 0);
+		}
+
+		// Mask of the valid bits in the last word of bit_count bits
+		constexpr std::uint64_t packed_bits_tail_mask(std::size_t bit_count) noexcept
+		{
+			return bit_count % 64 == 0 ? ~static_cast<std::uint64_t>(0) : (static_cast<std::uint64_t>(1) << (bit_count % 64)) - 1;
+		}
+
+		// Writes the words in chunks, so the counting bit_writer doesn't need memory for all of them
+		template<class WordAt>
+		FOX_SERIALIZE_INLINE void write_packed_words(bit_writer& writer, std::size_t words, WordAt word_at)
+		{
+			std::array<std::uint64_t, 32> chunk;
+			for (std::size_t w = 0; w < words; w += std::size(chunk))
+			{
+				const std::size_t count = std::min(std::size(chunk), words - w);
+				for (std::size_t i = 0; i < count; ++i)
+					chunk[i] = word_at(w + i);
+
+				writer.write_bytes(std::data(chunk), sizeof(std::uint64_t) * count);
+			}
+		}
+
+		// std::vector<bool> is serialized as a bit count followed by bits packed into 64 bit words
+		template<class Alloc>
+		struct builtin_serialize_traits<std::vector<bool, Alloc>>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::vector<bool, Alloc>& bits)
+			{
+				const std::size_t size = std::size(bits);
+				writer | size;
+
+				const std::size_t words = packed_bits_words(size);
+				if (words == 0)
+					return;
+
+				write_packed_words(writer, words, [&](std::size_t w)
+				{
+					std::uint64_t word = 0;
+					const std::size_t count = std::min<std::size_t>(64, size - w * 64);
+					for (std::size_t b = 0; b < count; ++b)
+						word |= static_cast<std::uint64_t>(bits[w * 64 + b]) << b;
+					return word;
+				});
+			}
+
+			static std::size_t serialized_size(const std::vector<bool, Alloc>& bits, bit_writer&)
+			{
+				return sizeof(std::size_t) + sizeof(std::uint64_t) * packed_bits_words(std::size(bits));
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::vector<bool, Alloc>& bits)
+			{
+				std::size_t size{};
+				reader | size;
+
+				const std::size_t words = packed_bits_words(size);
+				if (words > std::numeric_limits<std::size_t>::max() / sizeof(std::uint64_t))
+					throw std::out_of_range(std::format("Trying to read {} bits.", size));
+
+				reader.charge(words, sizeof(std::uint64_t), sizeof(std::uint64_t));
+				auto src = static_cast<const std::byte*>(reader.read_bytes(sizeof(std::uint64_t) * words));
+
+				// Only set bits are visited, the rest is cleared by assign
+				bits.assign(size, false);
+				for (std::size_t w = 0; w < words; ++w)
+				{
+					std::uint64_t word;
+					(void)std::memcpy(&word, src + w * sizeof(std::uint64_t), sizeof(std::uint64_t));
+					if (w == words - 1)
+						word &= packed_bits_tail_mask(size);
+
+					for (; word != 0; word &= word - 1)
+						bits[w * 64 + static_cast<std::size_t>(std::countr_zero(word))] = true;
+				}
+			}
+		};
+
+		// std::bitset is serialized as its bits packed into 64 bit words, independent of the implementation's layout
+		template<std::size_t Size>
+		struct builtin_serialize_traits<std::bitset<Size>>
+		{
+			static constexpr std::size_t words = packed_bits_words(Size);
+
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::bitset<Size>& bits)
+			{
+				if constexpr (words != 0)
+				{
+					if constexpr (words == 1)
+					{
+						const std::uint64_t word = bits.to_ullong();
+						writer.write_bytes(&word, sizeof(std::uint64_t));
+					}
+					else
+					{
+						write_packed_words(writer, words, [&](std::size_t w)
+						{
+							std::uint64_t word = 0;
+							const std::size_t count = std::min<std::size_t>(64, Size - w * 64);
+							for (std::size_t b = 0; b < count; ++b)
+								word |= static_cast<std::uint64_t>(bits[w * 64 + b]) << b;
+							return word;
+						});
+					}
+				}
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::bitset<Size>& bits)
+			{
+				if constexpr (words != 0)
+				{
+					auto src = static_cast<const std::byte*>(reader.read_bytes(sizeof(std::uint64_t) * words));
+					bits.reset();
+					for (std::size_t w = 0; w < words; ++w)
+					{
+						std::uint64_t word;
+						(void)std::memcpy(&word, src + w * sizeof(std::uint64_t), sizeof(std::uint64_t));
+						if (w == words - 1)
+							word &= packed_bits_tail_mask(Size);
+
+						for (; word != 0; word &= word - 1)
+							bits.set(w * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+					}
+				}
+			}
+		};
+#pragma endregion builtin_bits
+
+#pragma region builtin_multidimensional
+		template<class T>
+		struct is_md_array : std::false_type {};
+
+		template<class T, std::size_t Rank, class Allocator>
+		struct is_md_array<md_array<T, Rank, Allocator>> : std::true_type {};
+
+		// Extents are followed by the elements in the row-major order, regardless of the layout in memory
+		template<class T, std::size_t Rank, class Allocator>
+		struct builtin_serialize_traits<md_array<T, Rank, Allocator>>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const md_array<T, Rank, Allocator>& value) requires serializable<T>
+			{
+				for (const std::size_t extent : value.extents())
+					writer | extent;
+
+				if constexpr (memcpy_compatible_element<T>)
+				{
+					write_elements_padding<T>(writer);
+					writer.write_bytes(static_cast<const void*>(std::data(value)), sizeof(T) * std::size(value));
+				}
+				else
+				{
+					for (const T& e : value.flat())
+						writer | e;
+				}
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, md_array<T, Rank, Allocator>& value) requires deserializable<T>
+			{
+				const nesting_guard nesting(reader);
+
+				typename md_array<T, Rank, Allocator>::extents_type extents{};
+				for (std::size_t& extent : extents)
+					reader | extent;
+
+				const std::size_t count = md_array<T, Rank, Allocator>::element_count(extents);
+				reader.charge(count, sizeof(T), min_serialized_size<T>());
+				if constexpr (memcpy_compatible_element<T>)
+				{
+					if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+						throw std::out_of_range(std::format("Trying to read md_array of {} elements.", count));
+
+					read_elements_padding<T>(reader);
+					auto src = reader.read_bytes(sizeof(T) * count);
+					value.resize(extents);
+					(void)std::memcpy(static_cast<void*>(std::data(value)), src, sizeof(T) * count);
+				}
+				else
+				{
+					value.resize(extents);
+					for (T& e : value.flat())
+						reader | e;
+				}
+			}
+		};
+
+#if defined(__cpp_lib_mdspan)
+		// Calls f with indices of every element of the extents in the row-major order
+		template<class Extents, class F>
+		FOX_SERIALIZE_INLINE void for_each_md_index(const Extents& extents, F&& f)
+		{
+			constexpr std::size_t rank = Extents::rank();
+			std::array<typename Extents::index_type, rank> indices{};
+
+			if constexpr (rank == 0)
+			{
+				f(indices);
+			}
+			else
+			{
+				for (std::size_t r = 0; r < rank; ++r)
+				{
+					if (extents.extent(r) == 0)
+						return;
+				}
+
+				while (true)
+				{
+					f(indices);
+
+					std::size_t r = rank;
+					while (++indices[r - 1] == extents.extent(r - 1))
+					{
+						indices[r - 1] = 0;
+						if (--r == 0)
+							return;
+					}
+				}
+			}
+		}
+
+		template<class T, class Extents, class Layout, class Accessor>
+		struct builtin_serialize_traits<std::mdspan<T, Extents, Layout, Accessor>>
+		{
+			using mdspan_type = std::mdspan<T, Extents, Layout, Accessor>;
+			using value_type = std::remove_cv_t<T>;
+
+			// True if the elements are stored in the row-major order without gaps, so they can be copied with a single memcpy
+			[[nodiscard]] static bool row_major_contiguous(const mdspan_type& value)
+			{
+				if constexpr (!std::is_same_v<Accessor, std::default_accessor<T>> || !memcpy_compatible_element<value_type>)
+				{
+					return false;
+				}
+				else if constexpr (std::is_same_v<Layout, std::layout_right>)
+				{
+					return true;
+				}
+				else if constexpr (Extents::rank() > 0 && requires { value.mapping().stride(0); })
+				{
+					if (!value.is_exhaustive() || !value.is_strided())
+						return false;
+
+					// e.g. layout_left of rank 1, or with all but one extent equal to 1
+					std::size_t stride = 1;
+					for (std::size_t r = Extents::rank(); r-- > 0;)
+					{
+						if (value.extent(r) > 1 && static_cast<std::size_t>(value.stride(r)) != stride)
+							return false;
+						stride *= static_cast<std::size_t>(value.extent(r));
+					}
+					return true;
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const mdspan_type& value) requires serializable<value_type>
+			{
+				for (std::size_t r = 0; r < Extents::rank(); ++r)
+					writer | static_cast<std::size_t>(value.extent(r));
+
+				if constexpr (memcpy_compatible_element<value_type>)
+					write_elements_padding<value_type>(writer);
+
+				if (row_major_contiguous(value))
+				{
+					const std::size_t num_bytes = sizeof(value_type) * static_cast<std::size_t>(value.size());
+					writer.write_bytes(static_cast<const void*>(value.data_handle()), num_bytes);
+				}
+				else // Strided gather
+				{
+					for_each_md_index(value.extents(), [&](const auto& indices)
+					{
+						write_range_element<value_type>(writer, value[indices]);
+					});
+				}
+			}
+
+			// std::mdspan is a view, the data is read into the elements it views, extents have to match
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, mdspan_type& value) requires (!std::is_const_v<T> && deserializable<value_type>)
+			{
+				for (std::size_t r = 0; r < Extents::rank(); ++r)
+				{
+					std::size_t extent{};
+					reader | extent;
+					if (extent != static_cast<std::size_t>(value.extent(r)))
+					{
+						throw std::out_of_range(std::format("Trying to read extent {} of dimension {} into std::mdspan with extent {}.",
+							extent, r, value.extent(r))
+						);
+					}
+				}
+
+				if constexpr (memcpy_compatible_element<value_type>)
+					read_elements_padding<value_type>(reader);
+
+				if (row_major_contiguous(value))
+				{
+					const std::size_t num_bytes = sizeof(value_type) * static_cast<std::size_t>(value.size());
+					(void)std::memcpy(static_cast<void*>(value.data_handle()), reader.read_bytes(num_bytes), num_bytes);
+				}
+				else // Strided scatter
+				{
+					for_each_md_index(value.extents(), [&](const auto& indices)
+					{
+						if constexpr (memcpy_compatible_element<value_type>)
+						{
+							value_type element;
+							(void)std::memcpy(static_cast<void*>(std::addressof(element)), reader.read_bytes(sizeof(value_type)), sizeof(value_type));
+							value[indices] = element;
+						}
+						else
+						{
+							reader | value[indices];
+						}
+					});
+				}
+			}
+		};
+#endif
+#pragma endregion builtin_multidimensional
+
+#pragma region builtin_tuple_like
+		template<class T>
+			requires ( !std::ranges::range<T> && !std::is_trivially_copyable_v<T> && ::fox::serialize::details::tuple_like<T> )
+		struct builtin_serialize_traits<T>
+		{
+			template<std::size_t Idx, class U>
+			struct tuple_element_serializable : is_serializable<std::tuple_element_t<Idx, U>> {};
+
+			template<std::size_t Idx, class U>
+			struct tuple_element_deserializable : is_deserializable<std::tuple_element_t<Idx, U>> {};
+
+			using members = decltype([]<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				return std::type_identity<coalesced_members<std::tuple_element_t<Idx, T>...>>{};
+			}(std::make_index_sequence<std::tuple_size_v<T>>{}))::type;
+
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& tuple)
+				requires details::indexed_conjunction<tuple_element_serializable, T, std::tuple_size_v<T>>::value
+			{
+				members::serialize(writer, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+				{
+					return std::get<Idx>(tuple);
+				});
+			}
+
+			static std::size_t serialized_size(const T& tuple, bit_writer& counter)
+				requires details::indexed_conjunction<tuple_element_serializable, T, std::tuple_size_v<T>>::value
+			{
+				return members::serialized_size(counter, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) -> decltype(auto)
+				{
+					return std::get<Idx>(tuple);
+				});
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& tuple) requires
+				::fox::serialize::details::indexed_conjunction<tuple_element_deserializable, T, std::tuple_size_v<T>>::value
+			{
+				members::deserialize(reader, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+				{
+					return std::get<Idx>(tuple);
+				});
+			}
+		};
+#pragma endregion builtin_tuple_like
+
+#pragma region builtin_aggregate_types
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+		template<::fox::reflexpr::aggregate T>
+			requires ( !std::ranges::range<T> && (!std::is_trivially_copyable_v<T> || optional_members_aggregate<T>) && !::fox::serialize::details::tuple_like<T> )
+		struct builtin_serialize_traits<T>
+		{
+			using members = typename presence_members_of<decltype(fox::reflexpr::tie(std::declval<T&>()))>::type;
+
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& aggregate)
+				requires serializable<decltype(fox::reflexpr::tie(std::declval<T&>()))>
+			{
+				auto tie = fox::reflexpr::tie(aggregate);
+				members::serialize(writer, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+				{
+					return std::get<Idx>(tie);
+				});
+			}
+
+			static std::size_t serialized_size(const T& aggregate, bit_writer& counter)
+				requires serializable<decltype(fox::reflexpr::tie(std::declval<T&>()))>
+			{
+				auto tie = fox::reflexpr::tie(aggregate);
+				return members::serialized_size(counter, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) -> decltype(auto)
+				{
+					return std::get<Idx>(tie);
+				});
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& aggregate)
+				requires deserializable<decltype(fox::reflexpr::tie(std::declval<T&>()))>
+			{
+				auto tie = fox::reflexpr::tie(aggregate);
+				members::deserialize(reader, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+				{
+					return std::get<Idx>(tie);
+				});
+			}
+		};
+#endif
+#pragma endregion builtin_aggregate_types
+
+#pragma region builtin_variant
+
+		// Variant index is written in the smallest unsigned type that fits every alternative index and valueless marker
+		template<class Variant>
+		using variant_index_t = std::conditional_t<(std::variant_size_v<Variant> < std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+			std::conditional_t<(std::variant_size_v<Variant> < std::numeric_limits<std::uint16_t>::max()), std::uint16_t, std::uint32_t>>;
+
+		// Index written for the valueless variant
+		template<class Variant>
+		constexpr variant_index_t<Variant> variant_valueless_index = std::numeric_limits<variant_index_t<Variant>>::max();
+
+		template<class... Args>
+		struct builtin_serialize_traits<std::variant<Args...>>
+		{
+			using variant_type = std::variant<Args...>;
+			using index_type = variant_index_t<variant_type>;
+
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const variant_type& variant)
+				requires std::conjunction_v<is_serializable<Args>...>
+			{
+				if (variant.valueless_by_exception())
+				{
+					writer | variant_valueless_index<variant_type>;
+					return;
+				}
+
+				writer | static_cast<index_type>(variant.index());
+				std::visit([&](auto&& v) { writer | v; }, variant);
+			}
+
+			static std::size_t serialized_size(const variant_type& variant, bit_writer& counter)
+				requires std::conjunction_v<is_serializable<Args>...>
+			{
+				if (variant.valueless_by_exception())
+					return sizeof(index_type);
+
+				return sizeof(index_type) + std::visit([&]<class U>(const U& alternative)
+				{
+					return ::fox::serialize::details::dynamic_serialized_size<U>(alternative, counter);
+				}, variant);
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, variant_type& variant)
+				requires std::conjunction_v<is_deserializable<Args>...>
+			{
+				using alternative_function = void(*)(bit_reader&, variant_type&);
+				static constexpr auto alternatives = []<std::size_t... Is>(std::index_sequence<Is...>)
+				{
+					return std::array<alternative_function, sizeof...(Is)>{ &deserialize_alternative<Is>... };
+				}(std::index_sequence_for<Args...>{});
+
+				index_type idx{};
+				reader | idx;
+				if (idx == variant_valueless_index<variant_type>)
+					return;
+
+				if (idx >= sizeof...(Args))
+					throw std::invalid_argument("Invalid variant index."); // TODO: Custom exception type
+
+				alternatives[idx](reader, variant);
+			}
+
+		private:
+			template<std::size_t I>
+			static void deserialize_alternative(bit_reader& reader, variant_type& variant)
+			{
+				using c_alternative = std::variant_alternative_t<I, variant_type>;
+				using alternative = std::remove_const_t<c_alternative>;
+
+				if constexpr (custom_deserializable_construct<alternative>)
+				{
+					// Construct with reader if possible
+					variant.template emplace<c_alternative>(from_bit_reader, reader);
+				}
+				else
+				{
+					reader | variant.template emplace<c_alternative>();
+				}
+			}
+		};
+
+#pragma endregion builtin_variant
+
+#pragma region builtin_optional
+
+		template<class T>
+		struct builtin_serialize_traits<std::optional<T>>
+		{
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::optional<T>& optional)
+				requires is_serializable_v<T>
+			{
+				writer | optional.has_value();
+				if(optional.has_value())
+				{
+					writer | optional.value();
+				}
+			}
+
+			static std::size_t serialized_size(const std::optional<T>& optional, bit_writer& counter)
+				requires is_serializable_v<T>
+			{
+				return sizeof(bool) + (optional.has_value() ? ::fox::serialize::details::dynamic_serialized_size<T>(*optional, counter) : 0);
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::optional<T>& optional)
+				requires is_deserializable_v<T>
+			{
+				bool has_value = false;
+				reader | has_value;
+				if(has_value)
+				{
+					if constexpr (custom_deserializable_construct<T>)
+					{
+						// Construct with reader if possible
+						optional.emplace(from_bit_reader, reader);
+					}
+					else
+					{
+						reader | optional.emplace();
+					}
+				}
+				else
+				{
+					optional.reset();
+				}
+
+			}
+		};
+
+#pragma endregion builtin_variant
+
+#pragma region builtin_smart_pointers
+
+		template<class T>
+		struct is_smart_pointer : std::false_type {};
+
+		template<class T>
+		struct is_smart_pointer<std::unique_ptr<T>> : std::true_type {};
+
+		template<class T>
+		struct is_smart_pointer<std::shared_ptr<T>> : std::true_type {};
+
+		// Pointee requirements aren't part of the constraints so that recursive types, e.g. nodes of a linked list, can be serialized
+
+		template<class T> requires (!std::is_array_v<T>)
+		struct builtin_serialize_traits<std::unique_ptr<T>>
+		{
+			using value_type = std::remove_const_t<T>;
+
+			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::unique_ptr<T>& ptr)
+			{
+				writer | static_cast<bool>(ptr);
+				if (ptr)
+				{
+					writer | *ptr;
+				}
+			}
+
+			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::unique_ptr<T>& ptr)
+			{
+				bool has_value = false;
+				reader | has_value;
+				if (!has_value)
+				{
+					ptr.reset();
+					return;
+				}
+
+				const nesting_guard nesting(reader);
+				if constexpr (custom_deserializable_construct<value_type>)
+				{
+					// Construct with reader if possible
+					reader.charge(1, sizeof(value_type));
+					ptr = std::make_unique<value_type>(from_bit_reader, reader);
+				}
+				else if constexpr (!std::is_const_v<T>)
+				{
+					// Reuse already allocated pointee
+					if (!ptr)
+					{
+						reader.charge(1, sizeof(value_type));
+						ptr = std::make_unique<value_type>();
+					}
+
+					reader | *ptr;
+				}
+				else
+				{
+					reader.charge(1, sizeof(value_type));
+					std::unique_ptr<value_type> object = std::make_unique<value_type>();
+					reader | *object;
+					ptr = std::move(object);
+				}
+			}
+		};
+
+		/*
+		 * Each pointee is written once, following references to the same object are written as ids of the bit_writer's object table.
+		 * Tag: 0 - nullptr, 1 - new object follows, id + 2 - reference to the already written object.
+		 */
+		template<class T> requires (!std::is_array_v<T>)
+		struct builtin_serialize_traits<std::shared_ptr<T>>
+		{
+			using value_type = std::remove_const_t<T>;
+
+			static constexpr std::uint64_t null_tag = 0;
+			static constexpr std::uint64_t object_tag = 1;
+			static constexpr std::uint64_t first_reference_tag = 2;
+
+			static void serialize(bit_writer& writer, const std::shared_ptr<T>& ptr)
+			{
+				if (!ptr)
+				{
+					write_varint(writer, null_tag);
+					return;
+				}
+
+				writer_object_table& table = writer.object_table();
+				const object_key key{ static_cast<const void*>(ptr.get()), &object_type_tag<value_type>::value };
+				const auto [it, inserted] = table.ids.try_emplace(key, std::size(table.objects));
+				if (!inserted)
+				{
+					write_varint(writer, first_reference_tag + it->second);
+					return;
+				}
+
+				// Registered before the pointee is written so cyclic references resolve to the id
+				table.objects.push_back(ptr);
+				write_varint(writer, object_tag);
+				writer | *ptr;
+			}
+
+			static void deserialize(bit_reader& reader, std::shared_ptr<T>& ptr)
+			{
+				const std::uint64_t tag = read_varint(reader);
+				if (tag == null_tag)
+				{
+					ptr.reset();
+					return;
+				}
+
+				reader_object_table& table = reader.object_table();
+				const void* type = &object_type_tag<value_type>::value;
+
+				if (tag == object_tag)
+				{
+					const nesting_guard nesting(reader);
+					reader.charge(1, sizeof(value_type));
+
+					if constexpr (custom_deserializable_construct<value_type>)
+					{
+						// Id is reserved before the pointee is read, so ids of the objects it contains match the writer.
+						// The object doesn't exist until its constructor returns, references to it from inside are rejected.
+						const std::size_t id = std::size(table.objects);
+						table.objects.push_back({ nullptr, type });
+						std::shared_ptr<value_type> object = std::make_shared<value_type>(from_bit_reader, reader);
+						table.objects[id].object = object;
+						ptr = std::move(object);
+					}
+					else
+					{
+						// Registered before the pointee is read so cyclic references resolve to the object
+						std::shared_ptr<value_type> object = std::make_shared<value_type>();
+						table.objects.push_back({ object, type });
+						reader | *object;
+						ptr = std::move(object);
+					}
+					return;
+				}
+
+				const std::uint64_t id = tag - first_reference_tag;
+				if (id >= std::size(table.objects) || table.objects[static_cast<std::size_t>(id)].type != type)
+					throw std::invalid_argument("Invalid shared object reference.");
+
+				if (table.objects[static_cast<std::size_t>(id)].object == nullptr)
+					throw std::invalid_argument("Cyclic reference to shared object constructed from bit_reader.");
+
+				ptr = std::static_pointer_cast<value_type>(table.objects[static_cast<std::size_t>(id)].object);
+			}
+		};
+
+#pragma endregion builtin_smart_pointers
+
+		template<class C, class Member>
+		struct is_member_object_pointer_of : std::false_type {};
+
+		template<class C, class T>
+		struct is_member_object_pointer_of<C, T C::*> : std::true_type {};
+
+		template<class T>
+		struct remove_member_pointer;
+
+		template<class C, class T>
+		struct remove_member_pointer<T C::*>
+		{
+			using type = T;
+		};
+
+		template<class T, template<class...> class Template>
+		struct is_specialization_of : std::false_type {};
+
+		template<template<class...> class Template, class... Args>
+		struct is_specialization_of<Template<Args...>, Template> : std::true_type {};
+
+		template<std::size_t N, class OldGet, class NewGet>
+		void serialize_members_delta(bit_writer& writer, OldGet&& get_old, NewGet&& get_new);
+
+		template<std::size_t N, class Get>
+		void apply_members_delta(bit_reader& reader, Get&& get);
+	}
+
+	/**
+	 * \brief Helper class providing serialization trait from the members. Refer samples/sample_custom_4.cpp
+	 * \tparam T Object type
+	 * \tparam Members Member list
+	 */
+	template<class T, auto... Members> requires
+		std::conjunction_v<::fox::serialize::details::is_member_object_pointer_of<T, decltype(Members)>...>
+	struct serialize_from_members
+	{
+	private:
+		using members = ::fox::serialize::details::presence_members<typename ::fox::serialize::details::remove_member_pointer<decltype(Members)>::type...>;
+
+	public:
+		/**
+		 * \brief Types of the serialized members, in the serialization order.
+		 */
+		using serialized_members = std::tuple<typename ::fox::serialize::details::remove_member_pointer<decltype(Members)>::type...>;
+
+		FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& v)
+			requires std::conjunction_v<::fox::serialize::is_serializable<typename ::fox::serialize::details::remove_member_pointer<decltype(Members)>::type>...>
+		{
+			members::serialize(writer, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+			{
+				return (v.*std::get<Idx>(std::tuple{ Members... }));
+			});
+		}
+
+		FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& v)
+			requires std::conjunction_v<::fox::serialize::is_deserializable<typename ::fox::serialize::details::remove_member_pointer<decltype(Members)>::type>...>
+		{
+			members::deserialize(reader, [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+			{
+				return (v.*std::get<Idx>(std::tuple{ Members... }));
+			});
+		}
+
+		static void serialize_delta(bit_writer& writer, const T& old_value, const T& new_value)
+		{
+			::fox::serialize::details::serialize_members_delta<sizeof...(Members)>(writer,
+				[&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+				{
+					return (old_value.*std::get<Idx>(std::tuple{ Members... }));
+				},
+				[&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+				{
+					return (new_value.*std::get<Idx>(std::tuple{ Members... }));
+				});
+		}
+
+		static void apply_delta(bit_reader& reader, T& v)
+		{
+			::fox::serialize::details::apply_members_delta<sizeof...(Members)>(reader,
+				[&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+				{
+					return (v.*std::get<Idx>(std::tuple{ Members... }));
+				});
+		}
+	};
+
+#pragma region single_pass_ranges
+	/**
+	 * \brief Serializes elements of the range in a single pass, without computing its size first.
+	 * Ranges that can only be iterated once or only when non-const, e.g. filtered views or generators, are written without
+	 * an intermediate container. Data is read as any other range of its elements, e.g. std::vector.
+	 * Ranges of proxy references, e.g. std::vector<bool>, have their own wire format and are rejected.
+	 * \param writer bit_writer
+	 * \param range Range to serialize
+	 */
+	template<std::ranges::input_range Range> requires
+		serializable<std::ranges::range_value_t<Range>> && ::fox::serialize::details::element_reference_range<Range>
+	FOX_SERIALIZE_INLINE void serialize_range(bit_writer& writer, Range&& range)
+	{
+		using value_type = std::ranges::range_value_t<Range>;
+
+		if constexpr (std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>)
+		{
+			writer | std::span<const value_type>(std::ranges::data(range), std::ranges::size(range));
+		}
+		else if constexpr (std::ranges::sized_range<Range>)
+		{
+			const std::size_t size = static_cast<std::size_t>(std::ranges::size(range));
+			writer | size;
+			if constexpr (::fox::serialize::details::memcpy_compatible_element<value_type>)
+				::fox::serialize::details::write_elements_padding<value_type>(writer);
+
+			for (auto&& e : range)
+				::fox::serialize::details::write_range_element<value_type>(writer, e);
+		}
+		else
+		{
+			::fox::serialize::details::write_single_pass_range(writer, range);
+		}
+	}
+#pragma endregion single_pass_ranges
+
+#pragma region aligned_layout
+	/**
+	 * \brief Reads a range of trivially copyable elements without copying them, the returned view points into the bit_reader.
+	 * Data written with any range of T can be read, e.g. std::vector<T>. For in-place access the data has to be written
+	 * with bit_writer::set_alignment and the storage of the reader has to be aligned, e.g. with aligned_memory_resource.
+	 * \tparam T Element type
+	 * \param reader bit_reader with the same alignment as the writer
+	 * \return View of the elements, valid until the reader is modified.
+	 * \throws std::invalid_argument if the elements aren't aligned in memory
+	 */
+	template<class T> requires ::fox::serialize::details::memcpy_compatible_element<T>
+	[[nodiscard]] std::span<const T> read_span(bit_reader& reader)
+	{
+		std::size_t size{};
+		reader | size;
+
+		// Nothing is allocated, but the count is still checked against the limits and the data
+		reader.charge(size, 0, sizeof(T));
+		::fox::serialize::details::read_elements_padding<T>(reader);
+
+		const void* ptr = reader.read_bytes(sizeof(T) * size);
+		if (reinterpret_cast<std::uintptr_t>(ptr) % alignof(T) != 0)
+			throw std::invalid_argument("Elements aren't aligned for in-place access, refer to bit_writer::set_alignment.");
+
+		return { static_cast<const T*>(ptr), size };
+	}
+#pragma endregion aligned_layout
+
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+#pragma region flat_layout
+	namespace details
+	{
+		// Stored in the inline section as object bytes
+		template<class T>
+		concept flat_inline =
+			std::is_trivially_copyable_v<T> &&
+			!std::ranges::range<T> &&
+			!std::is_pointer_v<T> &&
+			!std::is_member_pointer_v<T>;
+
+		template<class T>
+		concept flat_string =
+			std::ranges::contiguous_range<T> &&
+			std::ranges::sized_range<T> &&
+			std::is_same_v<std::remove_cv_t<std::ranges::range_value_t<T>>, char>;
+
+		template<class T>
+		concept flat_range =
+			std::ranges::contiguous_range<T> &&
+			std::ranges::sized_range<T> &&
+			!flat_string<T> &&
+			flat_inline<std::remove_cv_t<std::ranges::range_value_t<T>>>;
+
+		template<class T>
+		using flat_members = std::remove_cvref_t<decltype(fox::reflexpr::tie(std::declval<T&>()))>;
+
+		template<class T, std::size_t Idx>
+		using flat_member = std::remove_cvref_t<std::tuple_element_t<Idx, flat_members<T>>>;
+
+		template<class T>
+		consteval bool flat_table_compatible();
+
+		template<class T>
+		consteval bool flat_member_compatible()
+		{
+			if constexpr (flat_inline<T> || flat_string<T> || flat_range<T>)
+				return true;
+			else if constexpr (::fox::reflexpr::aggregate<T>)
+				return flat_table_compatible<T>();
+			else
+				return false;
+		}
+
+		template<class T>
+		consteval bool flat_table_compatible()
+		{
+			return []<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				return (flat_member_compatible<flat_member<T, Idx>>() && ...);
+			}(std::make_index_sequence<std::tuple_size_v<flat_members<T>>>{});
+		}
+
+		// Every table starts with the inline section, a fixed size slot for every member.
+		// Trivially copyable members are stored in their slot, others store offset from the start of the table
+		// to their data: length and characters of strings, length and elements of arrays or the table of nested aggregates.
+		// Offsets always point past the inline section, so the data can't form cycles.
+		template<class T>
+		struct flat_table_layout
+		{
+			static constexpr std::size_t member_count = std::tuple_size_v<flat_members<T>>;
+
+			template<std::size_t Idx>
+			static constexpr std::size_t slot_size = flat_inline<flat_member<T, Idx>> ? sizeof(flat_member<T, Idx>) : sizeof(std::size_t);
+
+			static constexpr std::array<std::size_t, member_count + 1> slots = []<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				std::array<std::size_t, member_count + 1> slots{};
+				std::size_t offset = 0;
+				((slots[Idx] = offset, offset += slot_size<Idx>), ...);
+				slots[member_count] = offset;
+				return slots;
+			}(std::make_index_sequence<member_count>{});
+
+			static constexpr std::size_t inline_size = slots[member_count];
+		};
+
+		template<class T>
+		FOX_SERIALIZE_INLINE void write_flat_table(bit_writer& writer, const T& value)
+		{
+			using layout = flat_table_layout<T>;
+			const auto tie = fox::reflexpr::tie(value);
+			const std::size_t table = writer.size();
+
+			// Inline section is written at once, the pointer is invalidated by the following writes
+			std::byte* slots = static_cast<std::byte*>(writer.write_bytes(layout::inline_size));
+			(void)std::memset(slots, 0, layout::inline_size);
+			[&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				([&]
+				{
+					if constexpr (flat_inline<flat_member<T, Idx>>)
+						(void)std::memcpy(slots + layout::slots[Idx], std::addressof(std::get<Idx>(tie)), sizeof(flat_member<T, Idx>));
+				}(), ...);
+			}(std::make_index_sequence<layout::member_count>{});
+
+			[&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				([&]
+				{
+					using member_type = flat_member<T, Idx>;
+					if constexpr (!flat_inline<member_type>)
+					{
+						const member_type& member = std::get<Idx>(tie);
+						writer.patch(table + layout::slots[Idx], writer.size() - table);
+
+						if constexpr (flat_string<member_type> || flat_range<member_type>)
+						{
+							using element_type = std::remove_cv_t<std::ranges::range_value_t<member_type>>;
+							const std::size_t size = std::ranges::size(member);
+							const std::size_t num_bytes = sizeof(element_type) * size;
+
+							writer | size;
+							if (num_bytes != 0)
+								writer.write_bytes(static_cast<const void*>(std::ranges::data(member)), num_bytes);
+						}
+						else
+						{
+							write_flat_table(writer, member);
+						}
+					}
+				}(), ...);
+			}(std::make_index_sequence<layout::member_count>{});
+		}
+	}
+
+	/**
+	 * \brief Checks if the aggregate and all of its members can be written in the flat layout.
+	 * Members have to be trivially copyable, contiguous ranges of characters or trivially copyable elements, or aggregates
+	 * satisfying the same requirements.
+	 */
+	template<class T>
+	concept flat_serializable = ::fox::reflexpr::aggregate<T> && ::fox::serialize::details::flat_table_compatible<T>();
+
+	/**
+	 * \brief Read-only view of trivially copyable elements stored in the flat layout.
+	 * Elements are copied out of the buffer on access, so the data doesn't have to be aligned.
+	 * \tparam T Element type
+	 */
+	template<class T> requires ::fox::serialize::details::flat_inline<T>
+	class flat_array
+	{
+		std::span<const std::byte> bytes_;
+
+	public:
+		/**
+		 * \brief Default constructor. Constructs empty flat_array.
+		 */
+		flat_array() noexcept = default;
+
+		/**
+		 * \brief Constructs flat_array viewing the object bytes of the elements.
+		 * \param bytes Object bytes of the elements, the size has to be a multiple of sizeof(T).
+		 */
+		explicit flat_array(std::span<const std::byte> bytes) noexcept
+			: bytes_(bytes) {}
+
+	public:
+		/**
+		 * \brief Number of elements.
+		 */
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			return std::size(bytes_) / sizeof(T);
+		}
+
+		/**
+		 * \brief Checks if flat_array has no elements.
+		 */
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return std::empty(bytes_);
+		}
+
+		/**
+		 * \brief Returns copy of the element.
+		 * \param idx Index of the element
+		 */
+		[[nodiscard]] T operator[](std::size_t idx) const noexcept
+		{
+			T value;
+			(void)std::memcpy(static_cast<void*>(std::addressof(value)), std::data(bytes_) + idx * sizeof(T), sizeof(T));
+			return value;
+		}
+
+		/**
+		 * \brief Returns copy of the element.
+		 * \param idx Index of the element
+		 * \throws std::out_of_range if idx isn't smaller than size()
+		 */
+		[[nodiscard]] T at(std::size_t idx) const
+		{
+			if (idx >= size())
+				throw std::out_of_range(std::format("Trying to access element {} of flat_array of size {}.", idx, size()));
+
+			return (*this)[idx];
+		}
+
+		/**
+		 * \brief Object bytes of the elements.
+		 */
+		[[nodiscard]] std::span<const std::byte> bytes() const noexcept
+		{
+			return bytes_;
+		}
+
+		/**
+		 * \brief Copies the elements into a container.
+		 * \tparam Container Container constructible from a pair of iterators, e.g. std::vector<T>
+		 */
+		template<class Container = std::vector<T>>
+		[[nodiscard]] Container to() const
+		{
+			Container container;
+			if constexpr (requires { container.reserve(size()); })
+				container.reserve(size());
+
+			for (std::size_t i = 0; i < size(); ++i)
+				container.push_back((*this)[i]);
+			return container;
+		}
+	};
+
+	/**
+	 * \brief Writes the aggregate in the flat layout, which can be accessed with flat_view without deserializing it.
+	 * Every member has a fixed size slot in the inline section, variable length members store offset to their data
+	 * following the inline section. The layout is independent of the bit_writer format and the object bytes are
+	 * stored in the native byte order.
+	 * \param writer bit_writer, the data is written at its current position
+	 * \param value Aggregate to write
+	 * \throws std::out_of_range if the caller provided storage spills before the offsets are written, refer to bit_writer::patch.
+	 */
+	template<flat_serializable T>
+	FOX_SERIALIZE_INLINE void serialize_flat(bit_writer& writer, const T& value)
+	{
+		::fox::serialize::details::write_flat_table(writer, value);
+	}
+
+	/**
+	 * \brief Read-only accessor of the aggregate written with serialize_flat. Members are read directly from the buffer,
+	 * e.g. a memory mapped file, without deserializing the aggregate. Every access is checked against the size of the buffer,
+	 * so corrupted data results in an exception instead of out of bounds reads.
+	 * \tparam T Aggregate type
+	 */
+	template<flat_serializable T>
+	class flat_view
+	{
+		using layout = ::fox::serialize::details::flat_table_layout<T>;
+
+		std::span<const std::byte> data_;
+
+	public:
+		using value_type = T;
+
+		/**
+		 * \brief Constructs flat_view of the aggregate.
+		 * \param data Bytes starting at the aggregate, up to the end of the buffer. Data doesn't have to be aligned.
+		 * \throws end_of_buffer if the inline section of the aggregate doesn't fit into the data
+		 */
+		explicit flat_view(std::span<const std::byte> data)
+			: data_(data)
+		{
+			if (std::size(data_) < layout::inline_size)
+				throw end_of_buffer(layout::inline_size - std::size(data_));
+		}
+
+	public:
+		/**
+		 * \brief Number of the members of the aggregate.
+		 */
+		[[nodiscard]] static constexpr std::size_t size() noexcept
+		{
+			return layout::member_count;
+		}
+
+		/**
+		 * \brief Accesses the member of the aggregate.
+		 * \tparam Idx Index of the member
+		 * \return Copy of trivially copyable members, std::string_view of strings, flat_array of ranges of trivially
+		 * copyable elements and flat_view of nested aggregates. Views are valid as long as the buffer is.
+		 * \throws end_of_buffer if the member data doesn't fit into the buffer
+		 * \throws std::out_of_range if the offset of the member is invalid
+		 */
+		template<std::size_t Idx> requires (Idx < layout::member_count)
+		[[nodiscard]] auto get() const
+		{
+			using member_type = ::fox::serialize::details::flat_member<T, Idx>;
+
+			if constexpr (::fox::serialize::details::flat_inline<member_type>)
+			{
+				return load<member_type>(layout::slots[Idx]);
+			}
+			else
+			{
+				const auto offset = load<std::size_t>(layout::slots[Idx]);
+				if (offset < layout::inline_size || offset > std::size(data_))
+					throw std::out_of_range(std::format("Invalid offset {} of member {} in flat data of size {}.", offset, Idx, std::size(data_)));
+
+				if constexpr (::fox::serialize::details::flat_string<member_type> || ::fox::serialize::details::flat_range<member_type>)
+				{
+					using element_type = std::remove_cv_t<std::ranges::range_value_t<member_type>>;
+
+					const auto size = load<std::size_t>(offset);
+					const std::size_t remaining = std::size(data_) - offset - sizeof(std::size_t);
+					if (size > remaining / sizeof(element_type))
+						throw end_of_buffer(size - remaining / sizeof(element_type));
+
+					const auto bytes = data_.subspan(offset + sizeof(std::size_t), size * sizeof(element_type));
+					if constexpr (::fox::serialize::details::flat_string<member_type>)
+						return std::string_view(reinterpret_cast<const char*>(std::data(bytes)), size);
+					else
+						return flat_array<element_type>(bytes);
+				}
+				else
+				{
+					return flat_view<member_type>(data_.subspan(offset));
+				}
+			}
+		}
+
+		/**
+		 * \brief Deserializes the whole aggregate.
+		 * \throws end_of_buffer, std::out_of_range if the data is invalid
+		 */
+		[[nodiscard]] T to() const requires std::default_initializable<T>
+		{
+			T value{};
+			auto tie = fox::reflexpr::tie(value);
+			[&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				([&]
+				{
+					using member_type = ::fox::serialize::details::flat_member<T, Idx>;
+					auto member = get<Idx>();
+					if constexpr (::fox::serialize::details::flat_inline<member_type>)
+						std::get<Idx>(tie) = member;
+					else if constexpr (::fox::serialize::details::flat_string<member_type>)
+						std::get<Idx>(tie) = member_type(std::begin(member), std::end(member));
+					else if constexpr (::fox::serialize::details::flat_range<member_type>)
+						std::get<Idx>(tie) = member.template to<member_type>();
+					else
+						std::get<Idx>(tie) = member.to();
+				}(), ...);
+			}(std::make_index_sequence<layout::member_count>{});
+			return value;
+		}
+
+		/**
+		 * \brief Bytes starting at the aggregate, up to the end of the buffer.
+		 */
+		[[nodiscard]] std::span<const std::byte> data() const noexcept
+		{
+			return data_;
+		}
+
+	private:
+		template<class U>
+		[[nodiscard]] U load(std::size_t offset) const
+		{
+			if (offset > std::size(data_) || sizeof(U) > std::size(data_) - offset)
+				throw end_of_buffer(sizeof(U) - (std::size(data_) - std::min(offset, std::size(data_))));
+
+			U value;
+			(void)std::memcpy(static_cast<void*>(std::addressof(value)), std::data(data_) + offset, sizeof(U));
+			return value;
+		}
+	};
+#pragma endregion flat_layout
+#endif
+
+#pragma region serialized_size
+	namespace details
+	{
+		// Number of bytes T always serializes to, std::nullopt if it depends on the value
+		template<class T>
+		constexpr std::optional<std::size_t> static_serialized_size() noexcept;
+
+		template<class... Ts>
+		constexpr std::optional<std::size_t> static_serialized_size_sum() noexcept
+		{
+			const std::array<std::optional<std::size_t>, sizeof...(Ts)> sizes = { static_serialized_size<std::remove_cvref_t<Ts>>()... };
+			std::size_t sum = 0;
+			for (const auto& size : sizes)
+			{
+				if (!size.has_value())
+					return std::nullopt;
+				sum += *size;
+			}
+			return sum;
+		}
+
+		template<class T>
+		constexpr std::optional<std::size_t> static_serialized_size() noexcept
+		{
+			if constexpr (custom_serializable<T>)
+			{
+				return std::nullopt;
+			}
+			else if constexpr (bulk_copyable<T>)
+			{
+				return sizeof(T);
+			}
+			else if constexpr (ranged_enum<T>)
+			{
+				return sizeof(typename builtin_serialize_traits<T>::wire_type);
+			}
+			else if constexpr (is_bitset<T>::value)
+			{
+				return sizeof(std::uint64_t) * builtin_serialize_traits<T>::words;
+			}
+			else if constexpr (is_array<T>::value)
+			{
+				using value_type = std::ranges::range_value_t<T>;
+				if constexpr (memcpy_compatible_element<value_type>)
+				{
+					return sizeof(std::size_t) + sizeof(value_type) * std::tuple_size_v<T>;
+				}
+				else
+				{
+					constexpr auto element = static_serialized_size<value_type>();
+					if constexpr (element.has_value())
+						return sizeof(std::size_t) + *element * std::tuple_size_v<T>;
+					else
+						return std::nullopt;
+				}
+			}
+			else if constexpr (!std::ranges::range<T> && tuple_like<T>)
+			{
+				return []<std::size_t... Idx>(std::index_sequence<Idx...>)
+				{
+					return static_serialized_size_sum<std::tuple_element_t<Idx, T>...>();
+				}(std::make_index_sequence<std::tuple_size_v<T>>{});
+			}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+			else if constexpr (!std::ranges::range<T> && ::fox::reflexpr::aggregate<T>)
+			{
+				return static_serialized_size<std::remove_cvref_t<decltype(fox::reflexpr::tie(std::declval<T&>()))>>();
+			}
+#endif
+			else
+			{
+				return std::nullopt;
+			}
+		}
+
+		template<class T>
+		constexpr std::size_t min_serialized_size() noexcept
+		{
+			if constexpr (constexpr auto size = static_serialized_size<T>(); size.has_value())
+			{
+				return *size;
+			}
+			else if constexpr (custom_serializable<T> || custom_deserializable<T>)
+			{
+				return 0;
+			}
+			else if constexpr (std::ranges::range<T> || is_optional<T>::value || is_specialization_of<T, std::variant>::value ||
+				is_smart_pointer<T>::value || is_md_array<T>::value)
+			{
+				// Length, engaged flag, index or tag
+				return 1;
+			}
+			else if constexpr (tuple_like<T>)
+			{
+				return []<std::size_t... Idx>(std::index_sequence<Idx...>)
+				{
+					return (static_cast<std::size_t>(0) + ... + min_serialized_size<std::remove_cvref_t<std::tuple_element_t<Idx, T>>>());
+				}(std::make_index_sequence<std::tuple_size_v<T>>{});
+			}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+			else if constexpr (::fox::reflexpr::aggregate<T>)
+			{
+				using members = typename presence_members_of<decltype(fox::reflexpr::tie(std::declval<T&>()))>::type;
+				return members::bitmap_size + [&]<std::size_t... I>(std::index_sequence<I...>)
+				{
+					using tie_type = std::remove_cvref_t<decltype(fox::reflexpr::tie(std::declval<T&>()))>;
+					return (static_cast<std::size_t>(0) + ... + min_serialized_size<std::remove_cvref_t<std::tuple_element_t<members::value_indices[I], tie_type>>>());
+				}(std::make_index_sequence<std::size(members::value_indices)>{});
+			}
+#endif
+			else
+			{
+				return 0;
+			}
+		}
+
+		// Runs serialization methods of T with the counting writer
+		template<class T>
+		std::size_t counted_serialized_size(const T& value, bit_writer& counter)
+		{
+			const std::size_t before = counter.size();
+			::fox::serialize::details::do_serialize<T>(counter, value);
+			return counter.size() - before;
+		}
+
+		template<class T>
+		std::size_t dynamic_serialized_size(const T& value, bit_writer& counter)
+		{
+			if constexpr (constexpr auto size = static_serialized_size<T>(); size.has_value())
+			{
+				return *size;
+			}
+			else if constexpr (!custom_serializable<T> && builtin_sized<T>)
+			{
+				return builtin_serialize_traits<T>::serialized_size(value, counter);
+			}
+			else
+			{
+				return counted_serialized_size(value, counter);
+			}
+		}
+	}
+
+	/**
+	 * \brief Number of bytes type always serializes to, std::nullopt if it depends on the value.
+	 * \tparam T a type to check
+	 */
+	template<serializable T>
+	constexpr std::optional<std::size_t> static_serialized_size_v = ::fox::serialize::details::static_serialized_size<std::remove_cvref_t<T>>();
+
+	/**
+	 * \brief Computes the number of bytes values serialize to, without storing serialized data.
+	 * Builtin traits measure the values themselves, other serialization methods are run with the counting bit_writer.
+	 * \param values Objects to measure
+	 * \return Number of bytes
+	 */
+	template<serializable... Ts>
+	[[nodiscard]] std::size_t serialized_size(const Ts&... values)
+	{
+		if constexpr (constexpr auto size = ::fox::serialize::details::static_serialized_size_sum<Ts...>(); size.has_value())
+		{
+			return *size;
+		}
+		else
+		{
+			bit_writer counter(counting_writer);
+			return (static_cast<std::size_t>(0) + ... + ::fox::serialize::details::dynamic_serialized_size<Ts>(values, counter));
+		}
+	}
+#pragma endregion serialized_size
+
+#pragma region delta
+	namespace details
+	{
+		template<class T>
+		concept custom_delta_serialize_trait = requires (bit_writer & writer, bit_reader & reader, const T & a, T & b)
+		{
+			serialize_traits<T>::serialize_delta(writer, a, a);
+			serialize_traits<T>::apply_delta(reader, b);
+		};
+
+		template<class T>
+		concept custom_delta_member_serialize_trait = requires (bit_writer & writer, bit_reader & reader, const T & a, T & b)
+		{
+			T::serialize_trait::serialize_delta(writer, a, a);
+			T::serialize_trait::apply_delta(reader, b);
+		};
+
+		// Random access ranges that are patched element-wise, strings are always written as a whole
+		template<class T>
+		concept delta_patchable_range =
+			std::ranges::random_access_range<T> &&
+			std::ranges::sized_range<T> &&
+			!is_char_string<T>::value &&
+			std::is_lvalue_reference_v<std::ranges::range_reference_t<T>> &&
+			(is_array<T>::value || requires (T & range, std::size_t n) { range.resize(n); });
+
+		template<class T>
+		void do_serialize_delta(bit_writer& writer, const T& old_value, const T& new_value);
+
+		template<class T>
+		void do_apply_delta(bit_reader& reader, T& value);
+
+		// Values that can't be compared are always considered changed
+		template<class T>
+		FOX_SERIALIZE_INLINE bool delta_unchanged(const T& old_value, const T& new_value)
+		{
+			if constexpr (std::equality_comparable<T>)
+				return old_value == new_value;
+			else
+				return false;
+		}
+
+		/*
+		 * Members are written as a bitmap of changed members, bit I % 8 of byte I / 8 for member I,
+		 * followed by deltas of the changed members.
+		 */
+		template<std::size_t N, class OldGet, class NewGet>
+		void serialize_members_delta(bit_writer& writer, OldGet&& get_old, NewGet&& get_new)
+		{
+			std::array<std::uint8_t, (N + 7) / 8> bitmap{};
+			[&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				([&]
+				{
+					constexpr std::integral_constant<std::size_t, Idx> idx;
+					if (!delta_unchanged(get_old(idx), get_new(idx)))
+						bitmap[Idx / 8] |= static_cast<std::uint8_t>(1u << (Idx % 8));
+				}(), ...);
+
+				(void)std::memcpy(writer.write_bytes<sizeof(bitmap)>(), std::data(bitmap), sizeof(bitmap));
+
+				([&]
+				{
+					constexpr std::integral_constant<std::size_t, Idx> idx;
+					if (bitmap[Idx / 8] & (1u << (Idx % 8)))
+						do_serialize_delta<std::remove_cvref_t<decltype(get_new(idx))>>(writer, get_old(idx), get_new(idx));
+				}(), ...);
+			}(std::make_index_sequence<N>{});
+		}
+
+		template<std::size_t N, class Get>
+		void apply_members_delta(bit_reader& reader, Get&& get)
+		{
+			std::array<std::uint8_t, (N + 7) / 8> bitmap;
+			(void)std::memcpy(std::data(bitmap), reader.read_bytes<sizeof(bitmap)>(), sizeof(bitmap));
+
+			[&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				([&]
+				{
+					constexpr std::integral_constant<std::size_t, Idx> idx;
+					if (bitmap[Idx / 8] & (1u << (Idx % 8)))
+						do_apply_delta<std::remove_cvref_t<decltype(get(idx))>>(reader, get(idx));
+				}(), ...);
+			}(std::make_index_sequence<N>{});
+		}
+
+		// Estimated number of bytes range patch takes, stops counting once it exceeds the limit
+		template<class T>
+		std::size_t range_patch_size(const T& old_value, const T& new_value, std::size_t limit)
+		{
+			using value_type = std::ranges::range_value_t<T>;
+
+			const std::size_t new_size = std::size(new_value);
+			const std::size_t common = std::min(std::size(old_value), new_size);
+
+			bit_writer counter(counting_writer);
+			std::size_t size = varint_size(new_size) + varint_size(common) + max_varint_size;
+			for (std::size_t i = 0; i < common && size <= limit; ++i)
+			{
+				if (!delta_unchanged(old_value[i], new_value[i]))
+				{
+					size += varint_size(i) + dynamic_serialized_size<value_type>(new_value[i], counter);
+				}
+			}
+
+			for (std::size_t i = common; i < new_size && size <= limit; ++i)
+				size += dynamic_serialized_size<value_type>(new_value[i], counter);
+
+			return size;
+		}
+
+		/*
+		 * Ranges are written as a bool, false followed by the serialized range or true followed by the patch:
+		 * varint new size, varint number of common elements, varint number of changed common elements,
+		 * pairs of varint index and element delta, and elements appended after the common ones.
+		 */
+		template<class T>
+		void serialize_range_delta(bit_writer& writer, const T& old_value, const T& new_value)
+		{
+			const std::size_t full_size = serialized_size(new_value);
+			if (range_patch_size(old_value, new_value, full_size) >= full_size)
+			{
+				writer | false | new_value;
+				return;
+			}
+
+			const std::size_t new_size = std::size(new_value);
+			const std::size_t common = std::min(std::size(old_value), new_size);
+
+			std::size_t changed = 0;
+			for (std::size_t i = 0; i < common; ++i)
+				changed += delta_unchanged(old_value[i], new_value[i]) ? 0 : 1;
+
+			writer | true;
+			write_varint(writer, new_size);
+			write_varint(writer, common);
+			write_varint(writer, changed);
+			for (std::size_t i = 0; i < common && changed != 0; ++i)
+			{
+				if (!delta_unchanged(old_value[i], new_value[i]))
+				{
+					write_varint(writer, i);
+					do_serialize_delta<std::remove_cvref_t<decltype(new_value[i])>>(writer, old_value[i], new_value[i]);
+					--changed;
+				}
+			}
+
+			for (std::size_t i = common; i < new_size; ++i)
+				writer | new_value[i];
+		}
+
+		template<class T>
+		void apply_range_delta(bit_reader& reader, T& value)
+		{
+			bool patch = false;
+			reader | patch;
+			if (!patch)
+			{
+				reader | value;
+				return;
+			}
+
+			const auto new_size = static_cast<std::size_t>(read_varint(reader));
+			const auto common = static_cast<std::size_t>(read_varint(reader));
+			const auto changed = static_cast<std::size_t>(read_varint(reader));
+			if (common > new_size || common > std::size(value) || changed > common)
+				throw std::invalid_argument("Range delta doesn't match the range it's applied to.");
+
+			if constexpr (is_array<T>::value)
+			{
+				if (new_size != std::size(value))
+					throw std::invalid_argument("Range delta doesn't match the range it's applied to.");
+			}
+			else
+			{
+				// Only appended elements are allocated and read from the data
+				using value_type = std::ranges::range_value_t<T>;
+				reader.charge(new_size - common, sizeof(value_type), min_serialized_size<value_type>());
+				value.resize(new_size);
+			}
+
+			for (std::size_t i = 0; i < changed; ++i)
+			{
+				const auto index = static_cast<std::size_t>(read_varint(reader));
+				if (index >= common)
+					throw std::invalid_argument("Range delta doesn't match the range it's applied to.");
+
+				do_apply_delta<std::remove_cvref_t<decltype(value[index])>>(reader, value[index]);
+			}
+
+			for (std::size_t i = common; i < new_size; ++i)
+				reader | value[i];
+		}
+
+		template<class T>
+		void do_serialize_delta(bit_writer& writer, const T& old_value, const T& new_value)
+		{
+			if constexpr (custom_delta_serialize_trait<T>)
+			{
+				serialize_traits<T>::serialize_delta(writer, old_value, new_value);
+			}
+			else if constexpr (custom_delta_member_serialize_trait<T>)
+			{
+				T::serialize_trait::serialize_delta(writer, old_value, new_value);
+			}
+			else if constexpr (custom_serializable<T>)
+			{
+				writer | new_value;
+			}
+			else if constexpr (delta_patchable_range<T>)
+			{
+				serialize_range_delta(writer, old_value, new_value);
+			}
+			else if constexpr (!std::ranges::range<T> && tuple_like<T>)
+			{
+				serialize_members_delta<std::tuple_size_v<T>>(writer,
+					[&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+					{
+						return std::get<Idx>(old_value);
+					},
+					[&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+					{
+						return std::get<Idx>(new_value);
+					});
+			}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+			else if constexpr (!std::ranges::range<T> && ::fox::reflexpr::aggregate<T>)
+			{
+				auto old_tie = fox::reflexpr::tie(old_value);
+				auto new_tie = fox::reflexpr::tie(new_value);
+				do_serialize_delta<decltype(new_tie)>(writer, old_tie, new_tie);
+			}
+#endif
+			else
+			{
+				writer | new_value;
+			}
+		}
+
+		template<class T>
+		void do_apply_delta(bit_reader& reader, T& value)
+		{
+			if constexpr (custom_delta_serialize_trait<T>)
+			{
+				serialize_traits<T>::apply_delta(reader, value);
+			}
+			else if constexpr (custom_delta_member_serialize_trait<T>)
+			{
+				T::serialize_trait::apply_delta(reader, value);
+			}
+			else if constexpr (custom_deserializable<T>)
+			{
+				reader | value;
+			}
+			else if constexpr (delta_patchable_range<T>)
+			{
+				apply_range_delta(reader, value);
+			}
+			else if constexpr (!std::ranges::range<T> && tuple_like<T>)
+			{
+				apply_members_delta<std::tuple_size_v<T>>(reader,
+					[&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> decltype(auto)
+					{
+						return std::get<Idx>(value);
+					});
+			}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+			else if constexpr (!std::ranges::range<T> && ::fox::reflexpr::aggregate<T>)
+			{
+				auto tie = fox::reflexpr::tie(value);
+				do_apply_delta<decltype(tie)>(reader, tie);
+			}
+#endif
+			else
+			{
+				reader | value;
+			}
+		}
+	}
+
+	/**
+	 * \brief Serializes changes between two snapshots of the object. Refer to apply_delta.
+	 * Tuples, aggregates and serialize_from_members write a bitmap of changed members followed by deltas of the changed members,
+	 * random access ranges write a patch of changed elements when it's smaller than the whole range, other types are written whole.
+	 * Custom traits can provide serialize_delta(bit_writer&, const T&, const T&) and apply_delta(bit_reader&, T&) static functions.
+	 * \param writer bit_writer
+	 * \param old_value Snapshot the delta is computed against
+	 * \param new_value Current value
+	 */
+	template<serializable T>
+	void serialize_delta(bit_writer& writer, const T& old_value, const T& new_value)
+	{
+		::fox::serialize::details::do_serialize_delta<T>(writer, old_value, new_value);
+	}
+
+	/**
+	 * \brief Applies delta written by serialize_delta.
+	 * \param reader bit_reader
+	 * \param value Object equal to the old snapshot the delta was computed against, updated to the new value
+	 * \throws std::invalid_argument if the delta doesn't match the range it's applied to
+	 */
+	template<deserializable T>
+	void apply_delta(bit_reader& reader, T& value)
+	{
+		::fox::serialize::details::do_apply_delta<T>(reader, value);
+	}
+#pragma endregion delta
+
+#pragma region constant_evaluation
+	namespace details
+	{
+		// Writer usable in constant evaluation, counts bytes when out is nullptr
+		struct constant_writer
+		{
+			std::byte* out = nullptr;
+			std::size_t size = 0;
+
+			constexpr void write(const std::byte* bytes, std::size_t num_bytes)
+			{
+				if (out != nullptr)
+				{
+					for (std::size_t i = 0; i < num_bytes; ++i)
+						out[size + i] = bytes[i];
+				}
+				size += num_bytes;
+			}
+		};
+
+		// Reader usable in constant evaluation
+		struct constant_reader
+		{
+			std::span<const std::byte> bytes;
+			std::size_t offset = 0;
+
+			constexpr const std::byte* read(std::size_t num_bytes)
+			{
+				if (num_bytes > std::size(bytes) - offset)
+					throw end_of_buffer(num_bytes - (std::size(bytes) - offset));
+
+				const std::byte* ptr = std::data(bytes) + offset;
+				offset += num_bytes;
+				return ptr;
+			}
+		};
+
+		template<class T>
+		constexpr void constant_write_object(constant_writer& writer, const T& value)
+		{
+			const auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
+			writer.write(std::data(bytes), sizeof(T));
+		}
+
+		template<class T>
+		constexpr T constant_read_object(constant_reader& reader)
+		{
+			const std::byte* ptr = reader.read(sizeof(T));
+			std::array<std::byte, sizeof(T)> bytes;
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+				bytes[i] = ptr[i];
+
+			return std::bit_cast<T>(bytes);
+		}
+
+		template<class T>
+		concept constant_resizable_range = requires (T & range, std::size_t n) { range.resize(n); };
+
+		// Mirrors builtin serialization traits, producing the same bytes
+		template<class T>
+		constexpr void constant_serialize(constant_writer& writer, const T& value)
+		{
+			static_assert(!custom_serializable<T>, "Custom serialization methods can't be used in constant evaluation.");
+
+			if constexpr (bulk_copyable<T>)
+			{
+				constant_write_object(writer, value);
+			}
+			else if constexpr (ranged_enum<T>)
+			{
+				constant_write_object(writer, builtin_serialize_traits<T>::encode(value));
+			}
+			else if constexpr (is_vector_bool<T>::value)
+			{
+				const std::size_t size = std::size(value);
+				constant_write_object(writer, size);
+				for (std::size_t w = 0; w < packed_bits_words(size); ++w)
+				{
+					std::uint64_t word = 0;
+					for (std::size_t b = 0; b < 64 && w * 64 + b < size; ++b)
+						word |= static_cast<std::uint64_t>(value[w * 64 + b]) << b;
+					constant_write_object(writer, word);
+				}
+			}
+			else if constexpr (std::ranges::range<T>)
+			{
+				using value_type = std::ranges::range_value_t<T>;
+
+				constant_write_object(writer, static_cast<std::size_t>(std::ranges::distance(value)));
+				for (auto&& e : value)
+				{
+					if constexpr (memcpy_compatible_element<value_type>)
+						constant_write_object<value_type>(writer, e);
+					else
+						constant_serialize<value_type>(writer, e);
+				}
+			}
+			else if constexpr (is_specialization_of<T, std::optional>::value)
+			{
+				constant_write_object(writer, value.has_value());
+				if (value.has_value())
+					constant_serialize<typename T::value_type>(writer, *value);
+			}
+			else if constexpr (is_specialization_of<T, std::variant>::value)
+			{
+				if (value.valueless_by_exception())
+				{
+					constant_write_object(writer, variant_valueless_index<T>);
+					return;
+				}
+
+				constant_write_object(writer, static_cast<variant_index_t<T>>(value.index()));
+				std::visit([&]<class U>(const U& alternative) { constant_serialize<std::remove_const_t<U>>(writer, alternative); }, value);
+			}
+			else if constexpr (tuple_like<T>)
+			{
+				[&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+				{
+					(constant_serialize<std::remove_cvref_t<std::tuple_element_t<Idx, T>>>(writer, std::get<Idx>(value)), ...);
+				}(std::make_index_sequence<std::tuple_size_v<T>>{});
+			}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+			else if constexpr (::fox::reflexpr::aggregate<T>)
+			{
+				using members = typename presence_members_of<decltype(fox::reflexpr::tie(std::declval<T&>()))>::type;
+				const auto tie = fox::reflexpr::tie(value);
+
+				std::array<std::byte, members::bitmap_size> bitmap{};
+				[&]<std::size_t... J>(std::index_sequence<J...>)
+				{
+					((bitmap[J / 8] |= std::get<members::optional_indices[J]>(tie).has_value() ? static_cast<std::byte>(1u << (J % 8)) : std::byte{}), ...);
+				}(std::make_index_sequence<members::optional_count>{});
+				writer.write(std::data(bitmap), members::bitmap_size);
+
+				[&]<std::size_t... I>(std::index_sequence<I...>)
+				{
+					(constant_serialize<std::remove_cvref_t<decltype(std::get<members::value_indices[I]>(tie))>>(writer, std::get<members::value_indices[I]>(tie)), ...);
+				}(std::make_index_sequence<std::size(members::value_indices)>{});
+
+				[&]<std::size_t... J>(std::index_sequence<J...>)
+				{
+					([&]
+					{
+						if (const auto& optional = std::get<members::optional_indices[J]>(tie); optional.has_value())
+							constant_serialize<typename std::remove_cvref_t<decltype(optional)>::value_type>(writer, *optional);
+					}(), ...);
+				}(std::make_index_sequence<members::optional_count>{});
+			}
+#endif
+			else
+			{
+				static_assert(!std::is_same_v<T, T>, "[T] can't be serialized in constant evaluation.");
+			}
+		}
+
+		template<class T>
+		constexpr void constant_deserialize(constant_reader& reader, T& value)
+		{
+			static_assert(!custom_deserializable<T>, "Custom serialization methods can't be used in constant evaluation.");
+
+			if constexpr (bulk_copyable<T>)
+			{
+				value = constant_read_object<T>(reader);
+			}
+			else if constexpr (ranged_enum<T>)
+			{
+				value = builtin_serialize_traits<T>::decode(constant_read_object<typename builtin_serialize_traits<T>::wire_type>(reader));
+			}
+			else if constexpr (is_vector_bool<T>::value)
+			{
+				const auto size = constant_read_object<std::size_t>(reader);
+				value.resize(size);
+				for (std::size_t w = 0; w < packed_bits_words(size); ++w)
+				{
+					const auto word = constant_read_object<std::uint64_t>(reader);
+					for (std::size_t b = 0; b < 64 && w * 64 + b < size; ++b)
+						value[w * 64 + b] = ((word >> b) & 1) != 0;
+				}
+			}
+			else if constexpr (std::ranges::range<T>)
+			{
+				using value_type = std::ranges::range_value_t<T>;
+
+				const auto size = constant_read_object<std::size_t>(reader);
+				if constexpr (is_array<T>::value)
+				{
+					if (size != std::size(value))
+						throw std::out_of_range("Trying to read ranges of a different size than the array.");
+				}
+				else
+				{
+					static_assert(constant_resizable_range<T>, "[T] can't be deserialized in constant evaluation.");
+					value.resize(size);
+				}
+
+				for (auto&& e : value)
+				{
+					if constexpr (memcpy_compatible_element<value_type>)
+						e = constant_read_object<value_type>(reader);
+					else
+						constant_deserialize<value_type>(reader, e);
+				}
+			}
+			else if constexpr (is_specialization_of<T, std::optional>::value)
+			{
+				if (constant_read_object<bool>(reader))
+					constant_deserialize<typename T::value_type>(reader, value.emplace());
+				else
+					value.reset();
+			}
+			else if constexpr (is_specialization_of<T, std::variant>::value)
+			{
+				const auto idx = constant_read_object<variant_index_t<T>>(reader);
+				if (idx == variant_valueless_index<T>)
+					return;
+
+				if (idx >= std::variant_size_v<T>)
+					throw std::invalid_argument("Invalid variant index.");
+
+				[&]<std::size_t... Is>(std::index_sequence<Is...>)
+				{
+					(((Is == idx) ? constant_deserialize(reader, value.template emplace<Is>()) : void()), ...);
+				}(std::make_index_sequence<std::variant_size_v<T>>{});
+			}
+			else if constexpr (tuple_like<T>)
+			{
+				[&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+				{
+					(constant_deserialize<std::remove_cvref_t<std::tuple_element_t<Idx, T>>>(reader, std::get<Idx>(value)), ...);
+				}(std::make_index_sequence<std::tuple_size_v<T>>{});
+			}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+			else if constexpr (::fox::reflexpr::aggregate<T>)
+			{
+				using members = typename presence_members_of<decltype(fox::reflexpr::tie(std::declval<T&>()))>::type;
+				auto tie = fox::reflexpr::tie(value);
+
+				const std::byte* bitmap = reader.read(members::bitmap_size);
+
+				[&]<std::size_t... I>(std::index_sequence<I...>)
+				{
+					(constant_deserialize(reader, std::get<members::value_indices[I]>(tie)), ...);
+				}(std::make_index_sequence<std::size(members::value_indices)>{});
+
+				[&]<std::size_t... J>(std::index_sequence<J...>)
+				{
+					([&]
+					{
+						auto& optional = std::get<members::optional_indices[J]>(tie);
+						if ((bitmap[J / 8] & static_cast<std::byte>(1u << (J % 8))) != std::byte{})
+							constant_deserialize(reader, optional.emplace());
+						else
+							optional.reset();
+					}(), ...);
+				}(std::make_index_sequence<members::optional_count>{});
+			}
+#endif
+			else
+			{
+				static_assert(!std::is_same_v<T, T>, "[T] can't be deserialized in constant evaluation.");
+			}
+		}
+
+		template<class Make>
+		consteval std::size_t constant_serialized_size()
+		{
+			constant_writer counter;
+			constant_serialize(counter, Make{}());
+			return counter.size;
+		}
+	}
+
+	/**
+	 * \brief Serializes the value at compile time, producing the same bytes as bit_writer.
+	 * Supports builtin serialization of trivially copyable types, ranges, std::optional, std::variant, tuples and aggregates.
+	 * \param make Captureless lambda returning the value to serialize, e.g. []{ return std::array{ 1, 2, 3 }; }
+	 * \return Array of serialized bytes.
+	 */
+	template<class Make> requires std::is_empty_v<Make> && std::is_default_constructible_v<Make>
+	consteval auto serialize_to_array([[maybe_unused]] Make make)
+	{
+		constexpr std::size_t size = ::fox::serialize::details::constant_serialized_size<Make>();
+
+		std::array<std::byte, size> bytes{};
+		::fox::serialize::details::constant_writer writer{ std::data(bytes) };
+		::fox::serialize::details::constant_serialize(writer, Make{}());
+		return bytes;
+	}
+
+	/**
+	 * \brief Deserializes the value from the bytes. Usable in constant evaluation, refer to serialize_to_array.
+	 * \tparam T Type of the object to deserialize
+	 * \param bytes Serialized data
+	 * \return Deserialized object
+	 */
+	template<class T>
+	[[nodiscard]] constexpr T deserialize_from_array(std::span<const std::byte> bytes)
+	{
+		::fox::serialize::details::constant_reader reader{ bytes };
+		T value{};
+		::fox::serialize::details::constant_deserialize(reader, value);
+		return value;
+	}
+#pragma endregion constant_evaluation
+
+#pragma region schema_fingerprint
+	/**
+	 * \brief Exception thrown when the serialized schema fingerprint doesn't match the expected one.
+	 */
+	class schema_mismatch : public std::invalid_argument
+	{
+		std::uint64_t expected_;
+		std::uint64_t actual_;
+
+	public:
+		/**
+		 * \brief Constructs schema_mismatch exception.
+		 * \param expected Fingerprint of the type being deserialized.
+		 * \param actual Fingerprint read from the data.
+		 */
+		schema_mismatch(std::uint64_t expected, std::uint64_t actual)
+			: std::invalid_argument("Serialized data has a different schema."), expected_(expected), actual_(actual) {}
+
+		/**
+		 * \brief Fingerprint of the type being deserialized.
+		 */
+		[[nodiscard]] std::uint64_t expected() const noexcept
+		{
+			return expected_;
+		}
+
+		/**
+		 * \brief Fingerprint read from the data.
+		 */
+		[[nodiscard]] std::uint64_t actual() const noexcept
+		{
+			return actual_;
+		}
+	};
+
+	namespace details
+	{
+		enum class fingerprint_tag : std::uint8_t
+		{
+			boolean,
+			character,
+			signed_integer,
+			unsigned_integer,
+			floating_point,
+			enumeration,
+			trivially_copyable,
+			range,
+			array,
+			optional,
+			variant,
+			tuple,
+			aggregate,
+			unique_pointer,
+			shared_pointer,
+			custom,
+			recursion,
+			packed_bits,
+			multidimensional,
+			ranged_enumeration
+		};
+
+		// Nesting depth after which recursive types stop contributing to the fingerprint
+		constexpr std::size_t max_fingerprint_depth = 16;
+
+		// FNV-1a
+		constexpr std::uint64_t fingerprint_basis = 0xcbf29ce484222325ull;
+
+		constexpr std::uint64_t fingerprint_combine(std::uint64_t hash, std::uint64_t value) noexcept
+		{
+			for (std::size_t i = 0; i < sizeof(value); ++i)
+			{
+				hash ^= (value >> (8 * i)) & 0xFF;
+				hash *= 0x100000001b3ull;
+			}
+			return hash;
+		}
+
+		constexpr std::uint64_t fingerprint_combine(std::uint64_t hash, fingerprint_tag tag) noexcept
+		{
+			return fingerprint_combine(hash, static_cast<std::uint64_t>(tag));
+		}
+
+		constexpr std::uint64_t fingerprint_combine(std::uint64_t hash, std::string_view str) noexcept
+		{
+			for (const char c : str)
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(static_cast<unsigned char>(c)));
+			return hash;
+		}
+
+		template<class T>
+		concept custom_fingerprint_serialize_trait = requires { { serialize_traits<T>::schema_fingerprint } -> std::convertible_to<std::uint64_t>; };
+
+		template<class T>
+		concept custom_fingerprint_member = requires { { T::schema_fingerprint } -> std::convertible_to<std::uint64_t>; };
+
+		template<class T, std::size_t Depth = 0>
+		consteval std::uint64_t schema_fingerprint();
+
+		// Trait the custom serialization of T is selected from, void for the member functions
+		template<class T>
+		struct custom_trait_of
+		{
+			using type = void;
+		};
+
+		template<class T> requires custom_serializable_serialize_trait<T>
+		struct custom_trait_of<T>
+		{
+			using type = serialize_traits<T>;
+		};
+
+		template<class T> requires (!custom_serializable_serialize_trait<T> && !custom_serializable_member_function<T> &&
+			!custom_serializable_static_member_function<T> && custom_serializable_member_serialize_trait<T>)
+		struct custom_trait_of<T>
+		{
+			using type = typename T::serialize_trait;
+		};
+
+		template<class T>
+		concept serialized_from_members = requires { typename custom_trait_of<T>::type::serialized_members; };
+
+		template<class Tuple, std::size_t Depth>
+		consteval std::uint64_t elements_fingerprint(std::uint64_t hash)
+		{
+			return [&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(sizeof...(Idx)));
+				((hash = fingerprint_combine(hash, schema_fingerprint<std::tuple_element_t<Idx, Tuple>, Depth + 1>())), ...);
+				return hash;
+			}(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+		}
+
+		// Mirrors the traits selection, so types with the same wire format have the same fingerprint
+		template<class T, std::size_t Depth>
+		consteval std::uint64_t schema_fingerprint()
+		{
+			using type = std::remove_cvref_t<T>;
+			std::uint64_t hash = fingerprint_basis;
+
+			if constexpr (Depth > max_fingerprint_depth)
+			{
+				return fingerprint_combine(hash, fingerprint_tag::recursion);
+			}
+			else if constexpr (custom_fingerprint_serialize_trait<type>)
+			{
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::custom), serialize_traits<type>::schema_fingerprint);
+			}
+			else if constexpr (custom_fingerprint_member<type>)
+			{
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::custom), type::schema_fingerprint);
+			}
+			else if constexpr (serialized_from_members<type>)
+			{
+				// Members are written as the members of an aggregate
+				return elements_fingerprint<typename custom_trait_of<type>::type::serialized_members, Depth>(
+					fingerprint_combine(hash, fingerprint_tag::aggregate));
+			}
+			else if constexpr (custom_serializable<type> || custom_deserializable<type>)
+			{
+				// Layout of the custom serialization is unknown, type is identified by its name as the last resort.
+				// The name is spelled by the compiler, so the fingerprint isn't portable across compilers
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::custom), type_name<type>());
+			}
+			else if constexpr (bulk_copyable<type>)
+			{
+				// Object bytes are written as they are, so the layout and byte order are part of the schema
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(sizeof(type)));
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(alignof(type)));
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(std::endian::native == std::endian::little));
+
+				if constexpr (std::is_same_v<type, bool>)
+					return fingerprint_combine(hash, fingerprint_tag::boolean);
+				else if constexpr (std::is_same_v<type, char> || std::is_same_v<type, char8_t> || std::is_same_v<type, char16_t> || std::is_same_v<type, char32_t> || std::is_same_v<type, wchar_t>)
+					return fingerprint_combine(hash, fingerprint_tag::character);
+				else if constexpr (std::is_integral_v<type>)
+					return fingerprint_combine(hash, std::is_signed_v<type> ? fingerprint_tag::signed_integer : fingerprint_tag::unsigned_integer);
+				else if constexpr (std::is_floating_point_v<type>)
+					return fingerprint_combine(hash, fingerprint_tag::floating_point);
+				else if constexpr (std::is_enum_v<type>)
+					return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::enumeration), schema_fingerprint<std::underlying_type_t<type>, Depth + 1>());
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+				else if constexpr (::fox::reflexpr::aggregate<type>)
+					return elements_fingerprint<std::remove_cvref_t<decltype(fox::reflexpr::tie(std::declval<type&>()))>, Depth>(
+						fingerprint_combine(hash, fingerprint_tag::trivially_copyable));
+#endif
+				else
+					return fingerprint_combine(hash, fingerprint_tag::trivially_copyable);
+			}
+			else if constexpr (ranged_enum<type>)
+			{
+				// Offset from min is written, so the range is part of the schema, but not the underlying type
+				hash = fingerprint_combine(hash, fingerprint_tag::ranged_enumeration);
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(builtin_serialize_traits<type>::min));
+				return fingerprint_combine(hash, static_cast<std::uint64_t>(builtin_serialize_traits<type>::range));
+			}
+			else if constexpr (is_bitset<type>::value)
+			{
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::packed_bits), static_cast<std::uint64_t>(type{}.size()));
+			}
+			else if constexpr (is_vector_bool<type>::value)
+			{
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::range), fingerprint_tag::packed_bits);
+			}
+			else if constexpr (is_md_array<type>::value || is_mdspan<type>::value)
+			{
+				// md_array and std::mdspan of the same rank and element share the wire format
+				hash = fingerprint_combine(hash, fingerprint_tag::multidimensional);
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(type::rank()));
+				return fingerprint_combine(hash, schema_fingerprint<std::remove_cv_t<typename type::value_type>, Depth + 1>());
+			}
+			else if constexpr (is_array<type>::value)
+			{
+				hash = fingerprint_combine(hash, fingerprint_tag::array);
+				hash = fingerprint_combine(hash, static_cast<std::uint64_t>(std::tuple_size_v<type>));
+				return fingerprint_combine(hash, schema_fingerprint<std::ranges::range_value_t<type>, Depth + 1>());
+			}
+			else if constexpr (std::ranges::range<type>)
+			{
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::range), schema_fingerprint<std::ranges::range_value_t<type>, Depth + 1>());
+			}
+			else if constexpr (is_optional<type>::value)
+			{
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::optional), schema_fingerprint<typename type::value_type, Depth + 1>());
+			}
+			else if constexpr (is_specialization_of<type, std::variant>::value)
+			{
+				return [&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+				{
+					hash = fingerprint_combine(hash, fingerprint_tag::variant);
+					hash = fingerprint_combine(hash, static_cast<std::uint64_t>(sizeof...(Idx)));
+					((hash = fingerprint_combine(hash, schema_fingerprint<std::variant_alternative_t<Idx, type>, Depth + 1>())), ...);
+					return hash;
+				}(std::make_index_sequence<std::variant_size_v<type>>{});
+			}
+			else if constexpr (is_smart_pointer<type>::value)
+			{
+				hash = fingerprint_combine(hash, is_specialization_of<type, std::unique_ptr>::value ? fingerprint_tag::unique_pointer : fingerprint_tag::shared_pointer);
+				return fingerprint_combine(hash, schema_fingerprint<typename type::element_type, Depth + 1>());
+			}
+			else if constexpr (tuple_like<type>)
+			{
+				return elements_fingerprint<type, Depth>(fingerprint_combine(hash, fingerprint_tag::tuple));
+			}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+			else if constexpr (::fox::reflexpr::aggregate<type>)
+			{
+				return elements_fingerprint<std::remove_cvref_t<decltype(fox::reflexpr::tie(std::declval<type&>()))>, Depth>(
+					fingerprint_combine(hash, fingerprint_tag::aggregate));
+			}
+#endif
+			else
+			{
+				return fingerprint_combine(fingerprint_combine(hash, fingerprint_tag::custom), type_name<type>());
+			}
+		}
+	}
 
 	/**
-	 * \brief Serializes object into bit_writer
-	 * \tparam T Type of the object to serialize
-	 * \param lhs bit_writer
-	 * \param rhs object to serialize
-	 * \return lhs
+	 * \brief Fingerprint of the serialized layout of the type, derived from member types, their order and sizes.
+	 * Types with the same wire format, e.g. std::vector<int> and std::list<int>, have the same fingerprint.
+	 * serialize_from_members types are fingerprinted from their members. Other types with custom serialization methods are
+	 * identified by their name, unless the type or its serialize_traits provides static constexpr std::uint64_t schema_fingerprint.
+	 * The name is spelled by the compiler, so such fingerprints differ between compilers.
+	 * \tparam T a type to fingerprint
+	 */
+	template<class T>
+	constexpr std::uint64_t schema_fingerprint_v = ::fox::serialize::details::schema_fingerprint<T>();
+
+	/**
+	 * \brief Writes the schema fingerprint of T, it can be verified by the reader before deserializing T.
+	 * \param writer bit_writer
 	 */
 	template<serializable T>
-	FOX_SERIALIZE_INLINE bit_writer& operator|(bit_writer& lhs, const T& rhs)
+	FOX_SERIALIZE_INLINE void write_schema_fingerprint(bit_writer& writer)
 	{
-		::fox::serialize::details::do_serialize<T>(lhs, rhs);
-		return lhs;
+		writer | schema_fingerprint_v<T>;
 	}
 
 	/**
-	 * \brief Deserializes object from bit_reader
-	 * \tparam T Type of the object to deserialize
-	 * \param lhs bit_reader
-	 * \param rhs object to deserialize
-	 * \return lhs
+	 * \brief Reads the schema fingerprint written by write_schema_fingerprint and compares it with the fingerprint of T.
+	 * \param reader bit_reader
+	 * \throws schema_mismatch if the data was written with a different schema
 	 */
 	template<deserializable T>
-	FOX_SERIALIZE_INLINE bit_reader& operator|(bit_reader& lhs, T& rhs)
+	FOX_SERIALIZE_INLINE void verify_schema_fingerprint(bit_reader& reader)
 	{
-		::fox::serialize::details::do_deserialize<T>(lhs, rhs);
-		return lhs;
+		std::uint64_t fingerprint{};
+		reader | fingerprint;
+		if (fingerprint != schema_fingerprint_v<T>)
+			throw schema_mismatch(schema_fingerprint_v<T>, fingerprint);
+	}
+#pragma endregion schema_fingerprint
+
+#pragma region framing
+	namespace details
+	{
+		// Castagnoli polynomial, reflected
+		constexpr std::uint32_t crc32c_polynomial = 0x82F63B78u;
+
+		inline constexpr auto crc32c_tables = []() FOX_SERIALIZE_CONSTEXPR_LAMBDA
+		{
+			std::array<std::array<std::uint32_t, 256>, 8> tables{};
+			for (std::uint32_t i = 0; i < 256; ++i)
+			{
+				std::uint32_t crc = i;
+				for (int k = 0; k < 8; ++k)
+					crc = (crc & 1) ? (crc >> 1) ^ crc32c_polynomial : (crc >> 1);
+				tables[0][i] = crc;
+			}
+
+			for (std::size_t t = 1; t < std::size(tables); ++t)
+			{
+				for (std::size_t i = 0; i < 256; ++i)
+					tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+			}
+
+			return tables;
+		}();
+
+		// Slicing-by-8 implementation, operates on the inverted crc
+		inline std::uint32_t crc32c_portable(std::uint32_t crc, const std::byte* data, std::size_t size) noexcept
+		{
+			const auto& t = crc32c_tables;
+
+			if constexpr (std::endian::native == std::endian::little)
+			{
+				for (; size >= 8; size -= 8, data += 8)
+				{
+					std::uint64_t word;
+					(void)std::memcpy(&word, data, sizeof(word));
+					const auto lo = static_cast<std::uint32_t>(word) ^ crc;
+					const auto hi = static_cast<std::uint32_t>(word >> 32);
+					crc =
+						t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+						t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+				}
+			}
+
+			for (; size > 0; --size, ++data)
+				crc = t[0][(crc ^ static_cast<std::uint32_t>(*data)) & 0xFF] ^ (crc >> 8);
+
+			return crc;
+		}
+
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))
+
+		// SSE 4.2 implementation, operates on the inverted crc
+		inline std::uint32_t crc32c_sse42(std::uint32_t crc, const std::byte* data, std::size_t size) noexcept
+		{
+#if defined(__x86_64__) || defined(_M_X64)
+			std::uint64_t crc64 = crc;
+			for (; size >= 8; size -= 8, data += 8)
+			{
+				std::uint64_t word;
+				(void)std::memcpy(&word, data, sizeof(word));
+				crc64 = _mm_crc32_u64(crc64, word);
+			}
+			crc = static_cast<std::uint32_t>(crc64);
+#endif
+			for (; size >= 4; size -= 4, data += 4)
+			{
+				std::uint32_t word;
+				(void)std::memcpy(&word, data, sizeof(word));
+				crc = _mm_crc32_u32(crc, word);
+			}
+
+			for (; size > 0; --size, ++data)
+				crc = _mm_crc32_u8(crc, static_cast<std::uint8_t>(*data));
+
+			return crc;
+		}
+#endif
 	}
 
 	/**
-	 * \brief Serializes object into bit_writer
-	 * \tparam T Type of the object to serialize
-	 * \param lhs bit_writer
-	 * \param rhs object to serialize
+	 * \brief Computes CRC32C (Castagnoli) checksum. Uses SSE 4.2 crc32 instruction if the target supports it.
+	 * \param bytes Data to compute the checksum of.
+	 * \param crc Checksum of the preceding data, allows computing the checksum incrementally.
+	 * \return Checksum of the data.
 	 */
-	template<serializable T>
-	FOX_SERIALIZE_INLINE void serialize(bit_writer& lhs, const T& rhs)
+	[[nodiscard]] inline std::uint32_t crc32c(std::span<const std::byte> bytes, std::uint32_t crc = 0) noexcept
 	{
-		::fox::serialize::details::do_serialize<T>(lhs, rhs);
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))
+		return ~::fox::serialize::details::crc32c_sse42(~crc, std::data(bytes), std::size(bytes));
+#else
+		return ~::fox::serialize::details::crc32c_portable(~crc, std::data(bytes), std::size(bytes));
+#endif
 	}
 
 	/**
-	 * \brief Deserializes object from bit_reader
-	 * \tparam T Type of the object to deserialize
-	 * \param lhs bit_reader
-	 * \param rhs object to deserialize
+	 * \brief Frame read from a byte buffer. Payload points into the buffer frame was read from.
 	 */
-	template<serializable T>
-	FOX_SERIALIZE_INLINE void deserialize(bit_reader& lhs, const T& rhs)
+	struct frame
 	{
-		::fox::serialize::details::do_deserialize<T>(lhs, rhs);
+		std::span<const std::byte> payload;
+
+		// Number of bytes the frame takes in the buffer, including length prefix and checksum
+		std::size_t size;
+	};
+
+	/**
+	 * \brief Writes a frame: varint payload length, payload and CRC32C of both.
+	 * \param writer bit_writer to write frame to
+	 * \param payload Bytes of the payload
+	 */
+	inline void write_frame(bit_writer& writer, std::span<const std::byte> payload)
+	{
+		std::array<std::byte, ::fox::serialize::details::max_varint_size> length;
+		const std::size_t length_size = ::fox::serialize::details::encode_varint(std::size(payload), std::data(length));
+
+		writer.write_bytes(std::data(length), length_size);
+		writer.write_bytes(std::data(payload), std::size(payload));
+
+		const std::uint32_t crc = crc32c(payload, crc32c({ std::data(length), length_size }));
+		writer.write_bytes(&crc, sizeof(crc));
 	}
 
 	/**
-	 * \brief Deserializes object from bit_reader
-	 * \tparam T  Type of the object to deserialize
-	 * \param lhs bit_reader
-	 * \return deserialized object
+	 * \brief Serializes values and writes them as a single frame.
+	 * \param writer bit_writer to write frame to
+	 * \param values Values to serialize into the payload
 	 */
-	template<serializable T>
-	[[nodiscard]] FOX_SERIALIZE_INLINE T deserialize(bit_reader& lhs)
+	template<serializable... Ts>
+	void serialize_frame(bit_writer& writer, const Ts&... values)
 	{
-		if constexpr(::fox::serialize::details::custom_deserializable_construct<T>)
+		auto payload = acquire_writer();
+		((*payload | values), ...);
+		write_frame(writer, payload->data());
+	}
+
+	/**
+	 * \brief Parses a frame from the beginning of the buffer without copying the payload.
+	 * \param buffer Bytes to parse the frame from.
+	 * \return Parsed frame or std::nullopt if buffer doesn't contain the whole frame yet.
+	 * \throws std::invalid_argument if frame checksum doesn't match.
+	 */
+	[[nodiscard]] inline std::optional<frame> try_parse_frame(std::span<const std::byte> buffer)
+	{
+		std::uint64_t payload_size{};
+		const std::size_t length_size = ::fox::serialize::details::decode_varint(buffer, payload_size);
+		if (length_size == 0)
+			return std::nullopt;
+
+		const std::size_t available = std::size(buffer) - length_size;
+		if (available < sizeof(std::uint32_t) || available - sizeof(std::uint32_t) < payload_size)
+			return std::nullopt;
+
+		const std::size_t checked_size = length_size + static_cast<std::size_t>(payload_size);
+
+		std::uint32_t crc;
+		(void)std::memcpy(&crc, std::data(buffer) + checked_size, sizeof(crc));
+		if (crc != crc32c(buffer.first(checked_size)))
+			throw std::invalid_argument("Frame checksum mismatch.");
+
+		return frame{ buffer.subspan(length_size, static_cast<std::size_t>(payload_size)), checked_size + sizeof(crc) };
+	}
+
+	/**
+	 * \brief Reads a frame from bit_reader.
+	 * \param reader bit_reader to read frame from
+	 * \return Payload of the frame, valid until reader is modified.
+	 * \throws std::out_of_range if reader doesn't contain the whole frame.
+	 * \throws std::invalid_argument if frame checksum doesn't match.
+	 */
+	[[nodiscard]] inline std::span<const std::byte> read_frame(bit_reader& reader)
+	{
+		// Checksum covers the length bytes as they were written, not re-encoded
+		const std::size_t position = reader.position();
+		const std::uint64_t payload_size = ::fox::serialize::details::read_varint(reader);
+		const std::size_t length_size = reader.position() - position;
+
+		auto payload = static_cast<const std::byte*>(reader.read_bytes(static_cast<std::size_t>(payload_size)));
+		std::uint32_t crc;
+		(void)std::memcpy(&crc, reader.read_bytes<sizeof(crc)>(), sizeof(crc));
+
+		const std::uint32_t expected = crc32c({ payload - length_size, length_size + static_cast<std::size_t>(payload_size) });
+		if (crc != expected)
+			throw std::invalid_argument("Frame checksum mismatch.");
+
+		return { payload, static_cast<std::size_t>(payload_size) };
+	}
+
+	/**
+	 * \brief View over frames stored in a byte buffer. Iteration stops at the first incomplete frame.
+	 * Payloads of the frames point into the buffer.
+	 */
+	class frame_view : public std::ranges::view_interface<frame_view>
+	{
+		std::span<const std::byte> buffer_;
+
+	public:
+		class iterator
 		{
-			return T(from_bit_reader, lhs);
+			std::span<const std::byte> remaining_;
+			std::optional<frame> current_;
+
+		public:
+			using value_type = frame;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			explicit iterator(std::span<const std::byte> buffer)
+				: remaining_(buffer), current_(try_parse_frame(buffer)) {}
+
+			[[nodiscard]] const frame& operator*() const noexcept { return *current_; }
+			[[nodiscard]] const frame* operator->() const noexcept { return std::addressof(*current_); }
+
+			iterator& operator++()
+			{
+				remaining_ = remaining_.subspan(current_->size);
+				current_ = try_parse_frame(remaining_);
+				return *this;
+			}
+
+			void operator++(int) { ++*this; }
+
+			/**
+			 * \brief Bytes that were not consumed by the preceding frames.
+			 */
+			[[nodiscard]] std::span<const std::byte> remaining() const noexcept { return remaining_; }
+
+			[[nodiscard]] friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+			{
+				return !it.current_.has_value();
+			}
+		};
+
+		frame_view() = default;
+
+		explicit frame_view(std::span<const std::byte> buffer) noexcept
+			: buffer_(buffer) {}
+
+		[[nodiscard]] iterator begin() const { return iterator(buffer_); }
+		[[nodiscard]] std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+	};
+#pragma endregion framing
+
+#pragma region concurrent_append
+	/**
+	 * \brief Ring buffer that many producer threads append records to concurrently, drained in order by a single consumer.
+	 * Producers reserve space for a record with an atomic compare-and-swap, serialize directly into the reserved space
+	 * and publish the record with a commit marker. The consumer returns the space of drained records to the producers.
+	 * Neither producers nor the consumer take locks.
+	 */
+	class concurrent_append_buffer
+	{
+		// Every record starts with the header: payload length and commit marker holding the size of the record.
+		// Records are padded to a multiple of the header size, so a header always fits before the end of the buffer.
+		static constexpr std::size_t header_size = 2 * sizeof(std::uint64_t);
+
+		// Payload length of the records the consumer skips: abandoned records and the end of the buffer before wrapping
+		static constexpr std::uint64_t skipped = std::numeric_limits<std::uint64_t>::max();
+
+		std::unique_ptr<std::uint64_t[]> storage_;
+		std::size_t capacity_ = 0;
+
+		// Positions only grow, the offset in the buffer is the position modulo the capacity
+		alignas(64) std::atomic<std::uint64_t> tail_ = 0;
+		alignas(64) std::atomic<std::uint64_t> head_ = 0;
+
+	public:
+		/**
+		 * \brief Constructs concurrent_append_buffer.
+		 * \param capacity Number of bytes of the buffer, rounded up to a multiple of 16.
+		 */
+		explicit concurrent_append_buffer(std::size_t capacity)
+			: storage_(std::make_unique<std::uint64_t[]>(padded(capacity) / sizeof(std::uint64_t))), capacity_(padded(capacity)) {}
+
+		concurrent_append_buffer(const concurrent_append_buffer&) = delete;
+		concurrent_append_buffer& operator=(const concurrent_append_buffer&) = delete;
+
+	public:
+		/**
+		 * \brief Serializes values into a single record. Space is reserved for the size computed with serialized_size.
+		 * Thread safe, can be called concurrently with other producers and the consumer.
+		 * \param values Values to serialize
+		 * \return False if the buffer is full until the consumer drains it, the record isn't appended.
+		 * \throws buffer_overflow if the record is larger than the buffer
+		 */
+		template<serializable... Ts>
+		[[nodiscard]] bool append(const Ts&... values)
+		{
+			return append_bounded(serialized_size(values...), values...);
 		}
-		else
+
+		/**
+		 * \brief Serializes values into a single record, reserving max_size bytes for it instead of computing its size first.
+		 * Unused reserved bytes are skipped by the consumer. Thread safe.
+		 * \param max_size Upper bound of the serialized size of the values
+		 * \param values Values to serialize
+		 * \return False if the buffer is full until the consumer drains it, the record isn't appended.
+		 * \throws buffer_overflow if the reserved space is larger than the buffer, or the values don't fit into the reserved space
+		 */
+		template<serializable... Ts>
+		[[nodiscard]] bool append_bounded(std::size_t max_size, const Ts&... values)
 		{
-			static_assert(std::is_default_constructible_v<T>, "[T] is not default constructible.");
-			T v;
-			::fox::serialize::details::do_deserialize<T>(lhs, v);
-			return v;
+			const std::optional<reservation> record = reserve(max_size);
+			if (!record.has_value())
+				return false;
+
+			try
+			{
+				external_bit_writer writer(record->payload);
+				((writer | values), ...);
+				publish(*record, writer.size());
+			}
+			catch (...)
+			{
+				// Consumer skips the record instead of waiting for it forever
+				publish(*record, skipped);
+				throw;
+			}
+			return true;
 		}
-	}
 
-#pragma endregion traits
+		/**
+		 * \brief Appends the bytes as a single record. Thread safe.
+		 * \param bytes Payload of the record
+		 * \return False if the buffer is full until the consumer drains it, the record isn't appended.
+		 * \throws buffer_overflow if the record is larger than the buffer
+		 */
+		[[nodiscard]] bool append_bytes(std::span<const std::byte> bytes)
+		{
+			const std::optional<reservation> record = reserve(std::size(bytes));
+			if (!record.has_value())
+				return false;
 
-	namespace details
-	{
-		// This section provides implementation of default serialization functions for most common cases.
-		// Serializations are divided into sections and then later bunched together, this simplifies SFINAE-compatible implementation later
+			if (!std::empty(bytes))
+				(void)std::memcpy(std::data(record->payload), std::data(bytes), std::size(bytes));
+			publish(*record, std::size(bytes));
+			return true;
+		}
+
+		/**
+		 * \brief Calls f with payloads of committed records in the order they were reserved, stops at the first record
+		 * that isn't committed yet. Space of a record is returned to the producers once f returns, if f throws the record
+		 * is passed to f again by the next drain. Must be called from a single consumer thread at a time.
+		 * \param f Function called with std::span<const std::byte> payload of every record, valid until f returns.
+		 * \return Number of drained records.
+		 */
+		template<class F> requires std::invocable<F&, std::span<const std::byte>>
+		std::size_t drain(F&& f)
+		{
+			std::size_t count = 0;
+			std::uint64_t head = head_.load(std::memory_order_relaxed);
+			while (capacity_ != 0)
+			{
+				std::uint64_t* header = header_at(head);
+				const std::uint64_t size = std::atomic_ref<std::uint64_t>(header[1]).load(std::memory_order_acquire);
+				if (size == 0)
+					break;
+
+				if (header[0] != skipped)
+				{
+					f(std::span<const std::byte>(reinterpret_cast<const std::byte*>(header + 2), static_cast<std::size_t>(header[0])));
+					++count;
+				}
+
+				// Headers of the next records can land anywhere in the space, they have to read as uncommitted
+				std::fill_n(header, static_cast<std::size_t>(size) / sizeof(std::uint64_t), std::uint64_t{ 0 });
+				head += size;
+				head_.store(head, std::memory_order_release);
+			}
+			return count;
+		}
+
+		/**
+		 * \brief Discards all records. Not thread safe, producers and the consumer can't access the buffer concurrently.
+		 */
+		void reset() noexcept
+		{
+			std::fill_n(storage_.get(), capacity_ / sizeof(std::uint64_t), std::uint64_t{ 0 });
+			tail_.store(0, std::memory_order_relaxed);
+			head_.store(0, std::memory_order_relaxed);
+		}
+
+		/**
+		 * \brief Number of bytes of the buffer.
+		 */
+		[[nodiscard]] std::size_t capacity() const noexcept
+		{
+			return capacity_;
+		}
+
+		/**
+		 * \brief Number of bytes reserved by the producers and not drained yet, including headers and padding.
+		 */
+		[[nodiscard]] std::size_t reserved() const noexcept
+		{
+			const std::uint64_t head = head_.load(std::memory_order_relaxed);
+			return static_cast<std::size_t>(tail_.load(std::memory_order_relaxed) - head);
+		}
+
+	private:
+		[[nodiscard]] static constexpr std::size_t padded(std::size_t num_bytes) noexcept
+		{
+			return (num_bytes / header_size + (num_bytes % header_size != 0)) * header_size;
+		}
+
+		struct reservation
+		{
+			std::uint64_t* header;
+			std::span<std::byte> payload;
+			std::size_t size;
+		};
+
+		// Records don't wrap, the space left before the end of the buffer is reserved together with the record and skipped
+		[[nodiscard]] std::optional<reservation> reserve(std::size_t payload_size)
+		{
+			if (capacity_ < header_size || payload_size > capacity_ - header_size)
+				throw buffer_overflow(header_size + payload_size);
+
+			const std::size_t size = header_size + padded(payload_size);
+			std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				const std::size_t skip = capacity_ - offset(tail) < size ? capacity_ - offset(tail) : 0;
+				const std::uint64_t head = head_.load(std::memory_order_acquire);
+				if (tail + skip + size - head <= capacity_)
+				{
+					if (!tail_.compare_exchange_weak(tail, tail + skip + size, std::memory_order_relaxed))
+						continue;
+
+					if (skip != 0)
+					{
+						publish({ header_at(tail), {}, skip }, skipped);
+						tail += skip;
+					}
+
+					std::uint64_t* header = header_at(tail);
+					return reservation{ header, { reinterpret_cast<std::byte*>(header + 2), payload_size }, size };
+				}
+
+				// Record fits only at the beginning of the buffer, the end is skipped so it can be reserved once drained
+				if (skip == 0 || tail + skip - head > capacity_)
+					return std::nullopt;
+
+				if (tail_.compare_exchange_weak(tail, tail + skip, std::memory_order_relaxed))
+				{
+					publish({ header_at(tail), {}, skip }, skipped);
+					tail += skip;
+				}
+			}
+		}
+
+		[[nodiscard]] std::size_t offset(std::uint64_t position) const noexcept
+		{
+			return static_cast<std::size_t>(position % capacity_);
+		}
+
+		[[nodiscard]] std::uint64_t* header_at(std::uint64_t position) const noexcept
+		{
+			return storage_.get() + offset(position) / sizeof(std::uint64_t);
+		}
 
-#pragma region builtin_serialize_const_types
-		// Implementation for const-types
-		template<class T> requires builtin_serializable<T>
-		struct builtin_serialize_traits<const T>
+		static void publish(const reservation& record, std::uint64_t payload_size) noexcept
 		{
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& value)
-			{
-				do_serialize<T>(writer, value);
-			}
-		};
-#pragma endregion builtin_serialize_const_types
+			record.header[0] = payload_size;
+			std::atomic_ref<std::uint64_t>(record.header[1]).store(record.size, std::memory_order_release);
+		}
+	};
+#pragma endregion concurrent_append
 
-#pragma region builtin_serialize_reference_types
-		// Implementation for const-types
-		template<class T> requires builtin_serializable<T>
-		struct builtin_serialize_traits<T&>
+#pragma region async
+	/**
+	 * \brief Coroutine type of resumable deserialization. Started lazily, when awaited or resumed by async_decoder.
+	 */
+	class [[nodiscard]] decode_task
+	{
+	public:
+		struct promise_type
 		{
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& value)
-			{
-				do_serialize<T>(writer, value);
-			}
+			std::coroutine_handle<> continuation = std::noop_coroutine();
+			std::exception_ptr exception;
 
-			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& value)
+			decode_task get_return_object() noexcept
 			{
-				do_deserialize<T>(reader, value);
+				return decode_task(std::coroutine_handle<promise_type>::from_promise(*this));
 			}
-		};
-#pragma endregion builtin_serialize_reference_types
 
-#pragma region builtin_serialize_trivially_copyable
-		// Implementation for trivially copyable types
-		template<class T> requires ( !std::ranges::range<T> && std::is_trivially_copyable_v<T> )
-		struct builtin_serialize_traits<T>
-		{
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& value)
+			std::suspend_always initial_suspend() noexcept { return {}; }
+
+			struct final_awaiter
 			{
-				auto ptr = writer.write_bytes<sizeof(T)>();
-				*static_cast<T*>(ptr) = value;
-			}
+				bool await_ready() noexcept { return false; }
 
-			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& value)
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+				{
+					return handle.promise().continuation;
+				}
+
+				void await_resume() noexcept {}
+			};
+
+			final_awaiter final_suspend() noexcept { return {}; }
+
+			void return_void() noexcept {}
+
+			void unhandled_exception() noexcept
 			{
-				auto ptr = reader.read_bytes<sizeof(T)>();
-				value = *static_cast<const T*>(ptr);
+				exception = std::current_exception();
 			}
 		};
-#pragma endregion builtin_serialize_trivially_copyable
 
-#pragma region builtin_serialize_ranges
-		template<class T>
-		struct is_array : std::false_type {};
+	private:
+		std::coroutine_handle<promise_type> handle_;
 
-		template<class T, std::size_t Size>
-		struct is_array<std::array<T, Size>> : std::true_type {};
+		explicit decode_task(std::coroutine_handle<promise_type> handle) noexcept
+			: handle_(handle) {}
 
-		// Helper traits for std::ranges::to - concept 
-		template<class Container>
-		constexpr bool reservable_container =
-			std::ranges::sized_range<Container> &&
-		requires(Container& c, std::ranges::range_size_t<Container> n)
-		{
-			c.reserve(n);
-			{ c.capacity() } -> std::same_as<decltype(n)>;
-			{ c.max_size() } -> std::same_as<decltype(n)>;
-		};
+		template<class> friend class async_decoder;
 
-		template<class Container, class Ref>
-		constexpr bool container_insertable =
-			requires(Container& c, Ref&& ref)
-		{
-			requires(requires {c.push_back(std::forward<Ref>(ref)); } ||
-				requires {c.insert(c.end(), std::forward<Ref>(ref)); });
-		};
+	public:
+		decode_task(const decode_task&) = delete;
+		decode_task& operator=(const decode_task&) = delete;
 
-		// std::ranges::to concept, std::ranges::to isn't SFINAE compatible - it uses static_assert
-		template<class C, std::ranges::input_range R, class... Args>
-		constexpr bool is_ranges_to_convertible =
-			// Mandates: C is a cv-unqualified class type
-			std::is_const_v<C> == false &&
-			std::is_volatile_v<C> == false &&
-			std::is_class_v<C> == true &&
-			(
-			( 
-				(std::ranges::input_range<C> == false || std::convertible_to<std::ranges::range_reference_t<R>, std::ranges::range_value_t<R>> == true) &&
-				(
-					std::constructible_from<C, R, Args...> == true ||
-					std::constructible_from<C, std::from_range_t, R, Args...> == true ||
-					(
-						std::ranges::common_range<R> && 
-						std::derived_from<typename std::iterator_traits<std::ranges::iterator_t<R>>::iterator_category, std::input_iterator_tag> &&
-						std::constructible_from<C, std::ranges::iterator_t<R>, std::ranges::sentinel_t<R>, Args...> == true
-					) ||
-					(
-						std::constructible_from<C, Args...> == true &&
-						container_insertable<C, std::ranges::range_reference_t<R>> == true
-					)
-				)
-			) ||
-			( std::ranges::input_range<std::ranges::range_reference_t<R>> && std::convertible_to<std::ranges::range_reference_t<R>, C> )
-			);
+		decode_task(decode_task&& other) noexcept
+			: handle_(std::exchange(other.handle_, nullptr)) {}
 
-#pragma region tuple_like
-		template<template <std::size_t, class> class Trait, class T, class>
-		struct indexed_conjunction_proxy : std::false_type {};
+		decode_task& operator=(decode_task&& other) noexcept
+		{
+			if (this != std::addressof(other))
+			{
+				if (handle_)
+					handle_.destroy();
+				handle_ = std::exchange(other.handle_, nullptr);
+			}
+			return *this;
+		}
 
-		template<template <std::size_t, class> class Trait, class T, std::size_t... Idx>
-		struct indexed_conjunction_proxy<Trait, T, std::index_sequence<Idx...>> : std::conjunction<Trait<Idx, T>...> {};
+		~decode_task() noexcept
+		{
+			if (handle_)
+				handle_.destroy();
+		}
 
-		template<template <std::size_t, class> class Trait, class T, std::size_t Size>
-		struct indexed_conjunction : indexed_conjunction_proxy < Trait, T, std::make_index_sequence<Size>> {};
+	public:
+		bool await_ready() const noexcept { return false; }
 
-		template<template <std::size_t, class> class Trait, class T>
-		struct indexed_conjunction<Trait, T, static_cast<std::size_t>(0)> : std::true_type {};
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+		{
+			handle_.promise().continuation = continuation;
+			return handle_;
+		}
 
-		template<std::size_t Idx, class T>
-		constexpr bool has_tuple_element_v =
-			requires(T tuple)
+		void await_resume() const
 		{
-			typename std::tuple_element_t<Idx, std::remove_cvref_t<T>>;
-			{ std::get<Idx>(tuple) } -> std::convertible_to<const std::tuple_element_t<Idx, T>&>;
-		};
+			if (handle_.promise().exception)
+				std::rethrow_exception(handle_.promise().exception);
+		}
+	};
 
-		template<std::size_t Idx, class T>
-		struct has_tuple_element : std::bool_constant<has_tuple_element_v<Idx, T>> {};
+	/**
+	 * \brief bit_reader that data can be appended to while deserialization is suspended.
+	 */
+	class async_reader
+	{
+		bit_reader reader_;
+		std::coroutine_handle<> waiting_;
+		std::size_t requested_{};
 
-		template<class T>
-		constexpr bool is_tuple_like_v =
-			std::is_reference_v<T> == false &&
-			requires
-		{
-			typename std::tuple_size<T>::type;
-			requires std::derived_from<std::tuple_size<T>, std::integral_constant<std::size_t, std::tuple_size_v<T>>>;
-			requires indexed_conjunction<has_tuple_element, T, std::tuple_size_v<T>>::value;
-		};
+	public:
+		async_reader() = default;
 
-		template<class T>
-		concept tuple_like = is_tuple_like_v<T>;
-#pragma endregion tuple_like
+		/**
+		 * \brief Constructs an empty async_reader with the given memory resource.
+		 * \param mr Memory resource to construct async_reader with.
+		 */
+		explicit async_reader(std::pmr::memory_resource* mr)
+			: reader_(mr) {}
 
-		template<class T>
-		struct tuple_like_remove_const
-		{
-			using type = T;
-		};
+		async_reader(const async_reader&) = delete;
+		async_reader& operator=(const async_reader&) = delete;
 
-		template<template<class...> class Tuple, class... Ts> requires
-			is_tuple_like_v<Tuple<Ts...>> && std::is_constructible_v<Tuple<Ts...>, Tuple<std::remove_const_t<Ts>...>>
-		struct tuple_like_remove_const<Tuple<Ts...>>
+	public:
+		/**
+		 * \brief Underlying bit_reader.
+		 */
+		[[nodiscard]] bit_reader& reader() noexcept
 		{
-			using type = Tuple<std::remove_const_t<Ts>...>;
-		};
+			return reader_;
+		}
 
-		template<std::ranges::range T>
-		struct builtin_serialize_traits<T>
+		/**
+		 * \brief Appends received data. Already deserialized data is discarded.
+		 * \param bytes Received serialized data.
+		 */
+		void append(std::span<const std::byte> bytes)
 		{
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& range) requires
-				serializable<std::ranges::range_value_t<T>>
-			{
-				using value_type = std::ranges::range_value_t<T>;
+			if (reader_.position() > reader_.remaining())
+				reader_.discard_consumed();
 
-				const std::size_t range_size = std::size(range);
-				writer | range_size;
+			reader_.append(bytes);
+		}
 
-				// Check if we can memcpy the range
-				constexpr bool memcpy_compatible =
-					std::ranges::contiguous_range<T> &&
-					static_cast<bool>(fox::serialize::details::custom_serializable<value_type>) == false &&
-					static_cast<bool>(fox::serialize::details::custom_deserializable<value_type>) == false &&
-					std::is_trivially_copyable_v<value_type>;
+		/**
+		 * \brief Number of bytes suspended deserialization needs to make progress, 0 if it isn't suspended.
+		 */
+		[[nodiscard]] std::size_t bytes_needed() const noexcept
+		{
+			return waiting_ && requested_ > reader_.remaining() ? requested_ - reader_.remaining() : 0;
+		}
 
-				if constexpr (memcpy_compatible)
-				{
-					auto dest = static_cast<std::remove_const_t<T>*>(writer.write_bytes(sizeof(value_type) * range_size));
-					(void)std::memcpy(dest, std::data(range), sizeof(value_type) * range_size);
-				}
-				else // We iterate over the range
-				{
-					for (auto&& e : range)
-					{
-						writer | e;
-					}
-				}
-			}
+		/**
+		 * \brief Resumes suspended deserialization if enough data was appended.
+		 * \return true if deserialization was resumed
+		 */
+		bool resume()
+		{
+			if (!waiting_ || requested_ > reader_.remaining())
+				return false;
 
-			static constexpr bool is_deserializable =
-				!std::ranges::borrowed_range<T> &&
-				deserializable<tuple_like_remove_const<std::ranges::range_value_t<T>>> && // In case we are tuple with const member, remove const if constructible from it
-				(::fox::serialize::details::is_array<T>::value || 
-					(
-						::fox::serialize::details::is_ranges_to_convertible<T, std::span<const std::ranges::range_value_t<T>>> &&
-					(std::is_default_constructible_v<std::ranges::range_value_t<T>> || details::custom_deserializable_construct<T>)));
+			std::exchange(waiting_, nullptr).resume();
+			return true;
+		}
 
-			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& value) requires is_deserializable
-				
+		/**
+		 * \brief Returns awaitable suspending the coroutine until at least num_bytes are available.
+		 * \param num_bytes Number of bytes required to make progress.
+		 */
+		[[nodiscard]] auto need(std::size_t num_bytes) noexcept
+		{
+			struct awaiter
 			{
-				using value_type = typename tuple_like_remove_const<std::ranges::range_value_t<T>>::type;
-				using const_value_type = std::add_const_t<std::ranges::range_value_t<T>>;
-
-				std::size_t size{};
-				reader | size;
-
-				// Check if we can memcpy the range
-				constexpr bool memcpy_compatible =
-					static_cast<bool>(fox::serialize::details::custom_serializable<value_type>) == false &&
-					static_cast<bool>(fox::serialize::details::custom_deserializable<value_type>) == false &&
-					std::is_trivially_copyable_v<value_type>;
+				async_reader& self;
+				std::size_t num_bytes;
 
-				if constexpr (::fox::serialize::details::is_ranges_to_convertible<T, std::span<const value_type>> && memcpy_compatible)
+				bool await_ready() const noexcept
 				{
-					const value_type* ptr = static_cast<const value_type*>(reader.read_bytes(sizeof(value_type) * size));
-					value = std::span<const_value_type >{ ptr, size } | std::ranges::to<T>();
+					return self.reader_.remaining() >= num_bytes;
 				}
-				else if constexpr (::fox::serialize::details::is_array<T>::value)
-				{
-					if (size != std::size(value))
-					{
-						throw std::out_of_range(std::format("Trying to read ranges ({} elements) of a different size than the array ({} elements).",
-							size, std::size(value))
-						);
-					}
 
-					// Memcpy array
-					if constexpr (memcpy_compatible)
-					{
-						auto ptr = static_cast<const value_type*>(reader.read_bytes(sizeof(value_type) * size));
-						std::memcpy(static_cast<void*>(std::data(value)), static_cast<const void*>(ptr), sizeof(value_type) * size);
-					}
-					else // Or iterate over elements and serialize them
-					{
-						for (auto&& e : value)
-						{
-							reader | e;
-						}
-					}
-				}
-				else // Iterate over elements, serialize them and then convert them into the range
-				{
-					value = std::views::iota(static_cast<std::size_t>(0), size)
-						| std::views::transform([&](auto) FOX_SERIALIZE_CONSTEXPR_LAMBDA -> value_type
-						{
-							if constexpr(custom_deserializable_construct<value_type>)
-							{
-								// Construct with reader if possible
-								value_type v(from_bit_reader, reader);
-								return v;
-							}
-							else
-							{
-								value_type v;
-								reader | v;
-								return v;
-							}
-						})
-						| std::views::as_rvalue
-						| std::ranges::to<T>();
+				void await_suspend(std::coroutine_handle<> handle) noexcept
+				{
+					self.waiting_ = handle;
+					self.requested_ = num_bytes;
 				}
-			}
-		};
 
-#pragma endregion builtin_serialize_ranges
+				void await_resume() const noexcept {}
+			};
 
-#pragma region builtin_tuple_like
+			return awaiter{ *this, num_bytes };
+		}
+	};
+
+	template<deserializable T>
+	decode_task deserialize_async(async_reader& reader, T& value);
+
+	namespace details
+	{
+		// Deserializes value if the reader has enough data, otherwise rewinds the reader and returns false
 		template<class T>
-			requires ( !std::ranges::range<T> && !std::is_trivially_copyable_v<T> && ::fox::serialize::details::tuple_like<T> )
-		struct builtin_serialize_traits<T>
+		FOX_SERIALIZE_INLINE bool try_deserialize(bit_reader& reader, T& value)
 		{
-			template<std::size_t Idx, class U>
-			struct tuple_element_serializable : is_serializable<std::tuple_element_t<Idx, U>> {};
+			const bit_reader::marker marker = reader.mark();
+			try
+			{
+				::fox::serialize::details::do_deserialize<T>(reader, value);
+				return true;
+			}
+			catch (const end_of_buffer&)
+			{
+				reader.rewind(marker);
+				return false;
+			}
+		}
 
-			template<std::size_t Idx, class U>
-			struct tuple_element_deserializable : is_deserializable<std::tuple_element_t<Idx, U>> {};
+		// Deserializes value synchronously if possible, otherwise returns a coroutine to await
+		template<class T>
+		FOX_SERIALIZE_INLINE std::optional<decode_task> deserialize_or_suspend(async_reader& reader, T& value)
+		{
+			if (try_deserialize(reader.reader(), value))
+				return std::nullopt;
 
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& tuple)
-				requires details::indexed_conjunction<tuple_element_serializable, T, std::tuple_size_v<T>>::value
+			return ::fox::serialize::deserialize_async(reader, value);
+		}
+
+		// Deserializes T as a whole, retrying from the beginning of T when more data arrives
+		template<class T>
+		decode_task deserialize_retry_async(async_reader& reader, T& value)
+		{
+			for (;;)
 			{
-				[&] <std::size_t... Idx>(std::index_sequence<Idx...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
+				bit_reader& r = reader.reader();
+				const bit_reader::marker marker = r.mark();
+				std::size_t missing = 0;
+				try
 				{
-					(::fox::serialize::details::do_serialize<std::tuple_element_t<Idx, T>>(writer, std::get<Idx>(tuple)), ...);
-				}(std::make_index_sequence<std::tuple_size_v<T>>{});
+					::fox::serialize::details::do_deserialize<T>(r, value);
+					co_return;
+				}
+				catch (const end_of_buffer& e)
+				{
+					missing = e.missing();
+				}
+
+				r.rewind(marker);
+				co_await reader.need(r.remaining() + missing);
 			}
+		}
 
-			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& tuple) requires
-				::fox::serialize::details::indexed_conjunction<tuple_element_deserializable, T, std::tuple_size_v<T>>::value
+		template<std::size_t Idx, class Tuple>
+		std::optional<decode_task> deserialize_tuple_element_async(async_reader& reader, Tuple& tuple)
+		{
+			return deserialize_or_suspend(reader, std::get<Idx>(tuple));
+		}
+
+		template<class Tuple>
+		decode_task deserialize_tuple_async(async_reader& reader, Tuple& tuple)
+		{
+			using element_function = std::optional<decode_task>(*)(async_reader&, Tuple&);
+			static constexpr auto elements = []<std::size_t... Idx>(std::index_sequence<Idx...>)
 			{
-				[&] <std::size_t... Idx>(std::index_sequence<Idx...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
-				{
-					(::fox::serialize::details::do_deserialize<std::tuple_element_t<Idx, T>>(reader, std::get<Idx>(tuple)), ...);
-				}(std::make_index_sequence<std::tuple_size_v<T>>{});
+				return std::array<element_function, sizeof...(Idx)>{ &deserialize_tuple_element_async<Idx, Tuple>... };
+			}(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+
+			for (const element_function element : elements)
+			{
+				if (auto task = element(reader, tuple))
+					co_await std::move(*task);
 			}
-		};
-#pragma endregion builtin_tuple_like
+		}
 
-#pragma region builtin_aggregate_types
-#ifdef FOX_SERIALIZE_HAS_REFLEXPR
-		template<::fox::reflexpr::aggregate T>
-			requires ( !std::ranges::range<T> && !std::is_trivially_copyable_v<T> && !::fox::serialize::details::tuple_like<T> )
-		struct builtin_serialize_traits<T>
+		template<std::size_t Idx, class Variant>
+		std::optional<decode_task> deserialize_variant_alternative_async(async_reader& reader, Variant& variant)
 		{
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& aggregate)
-				requires serializable<decltype(fox::reflexpr::tie(std::declval<T&>()))>
+			using alternative = std::variant_alternative_t<Idx, Variant>;
+			if constexpr (std::is_default_constructible_v<alternative>)
 			{
-				auto tie = fox::reflexpr::tie(aggregate);
-				::fox::serialize::details::do_serialize<decltype(tie)>(writer, tie);
+				return deserialize_or_suspend(reader, variant.template emplace<Idx>());
 			}
+			else
+			{
+				// Alternative constructed from the reader, variant is retried as a whole starting from its index
+				bit_reader& r = reader.reader();
+				r.seek(r.position() - sizeof(variant_index_t<Variant>));
+				if (try_deserialize(r, variant))
+					return std::nullopt;
 
-			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& aggregate)
-				requires deserializable<decltype(fox::reflexpr::tie(std::declval<T&>()))>
+				return deserialize_retry_async(reader, variant);
+			}
+		}
+
+	}
+
+	/**
+	 * \brief Deserializes value from async_reader, suspending whenever the reader runs out of data.
+	 * Builtin types are resumed where they stopped, types with custom traits are retried as a whole.
+	 * \tparam T Type of the object to deserialize
+	 * \param reader async_reader to deserialize from
+	 * \param value object to deserialize
+	 * \return Coroutine performing the deserialization.
+	 */
+	template<deserializable T>
+	decode_task deserialize_async(async_reader& reader, T& value)
+	{
+		using namespace ::fox::serialize::details;
+		bit_reader& r = reader.reader();
+
+		if constexpr (custom_deserializable<T>)
+		{
+			co_await deserialize_retry_async(reader, value);
+		}
+		else if constexpr (bulk_copyable<T>)
+		{
+			co_await reader.need(sizeof(T));
+			do_deserialize<T>(r, value);
+		}
+		else if constexpr (ranged_enum<T>)
+		{
+			co_await reader.need(sizeof(typename builtin_serialize_traits<T>::wire_type));
+			do_deserialize<T>(r, value);
+		}
+		else if constexpr (is_bitset<T>::value)
+		{
+			co_await reader.need(sizeof(std::uint64_t) * builtin_serialize_traits<T>::words);
+			do_deserialize<T>(r, value);
+		}
+		else if constexpr (is_vector_bool<T>::value)
+		{
+			std::size_t size{};
+			co_await reader.need(sizeof(size));
+			r | size;
+			r.seek(r.position() - sizeof(size));
+
+			const std::size_t words = packed_bits_words(size);
+			if (words > (std::numeric_limits<std::size_t>::max() - sizeof(size)) / sizeof(std::uint64_t))
+				throw std::out_of_range(std::format("Trying to read {} bits.", size));
+
+			co_await reader.need(sizeof(size) + sizeof(std::uint64_t) * words);
+			do_deserialize<T>(r, value);
+		}
+		else if constexpr (is_specialization_of<T, std::optional>::value)
+		{
+			bool has_value = false;
+			co_await reader.need(sizeof(has_value));
+			r | has_value;
+			if (!has_value)
 			{
-				auto tie = fox::reflexpr::tie(aggregate);
-				::fox::serialize::details::do_deserialize<decltype(tie)>(reader, tie);
+				value.reset();
 			}
-		};
-#endif
-#pragma endregion builtin_aggregate_types
+			else if constexpr (std::is_default_constructible_v<typename T::value_type>)
+			{
+				if (auto task = deserialize_or_suspend(reader, value.emplace()))
+					co_await std::move(*task);
+			}
+			else
+			{
+				value.reset();
+				r.seek(r.position() - sizeof(has_value));
+				co_await deserialize_retry_async(reader, value);
+			}
+		}
+		else if constexpr (is_specialization_of<T, std::variant>::value)
+		{
+			using element_function = std::optional<decode_task>(*)(async_reader&, T&);
+			static constexpr auto alternatives = []<std::size_t... Idx>(std::index_sequence<Idx...>)
+			{
+				return std::array<element_function, sizeof...(Idx)>{ &deserialize_variant_alternative_async<Idx, T>... };
+			}(std::make_index_sequence<std::variant_size_v<T>>{});
 
-#pragma region builtin_variant
+			variant_index_t<T> idx{};
+			co_await reader.need(sizeof(idx));
+			r | idx;
+			if (idx != variant_valueless_index<T>)
+			{
+				if (idx >= std::variant_size_v<T>)
+					throw std::invalid_argument("Invalid variant index.");
 
-		template<class... Args>
-		struct builtin_serialize_traits<std::variant<Args...>>
+				if (auto task = alternatives[idx](reader, value))
+					co_await std::move(*task);
+			}
+		}
+		else if constexpr (is_array<T>::value)
 		{
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::variant<Args...>& variant)
-				requires std::conjunction_v<is_serializable<Args>...>
+			std::size_t size{};
+			co_await reader.need(sizeof(size));
+			r | size;
+			if (size != std::size(value))
 			{
-				const std::size_t idx = variant.index();
-				writer | idx;
-				if(idx != std::variant_npos)
-				{
-					std::visit([&](auto&& v) { writer | v; }, variant);
-				}
+				throw std::out_of_range(std::format("Trying to read ranges ({} elements) of a different size than the array ({} elements).",
+					size, std::size(value))
+				);
 			}
 
-			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::variant<Args...>& variant)
-				requires std::conjunction_v<is_deserializable<Args>...>
+			if constexpr (memcpy_compatible_element<std::ranges::range_value_t<T>>)
 			{
-				std::size_t idx;
-				reader | idx;
-				if (idx != std::variant_npos)
+				if (const std::size_t alignment = std::max(r.alignment(), alignof(std::ranges::range_value_t<T>)); r.alignment() != 0)
 				{
-					if (idx >= std::variant_size_v<std::variant<Args...>>)
-						throw std::invalid_argument("Invalid variant index."); // TODO: Custom exception type
+					co_await reader.need(r.padding(alignment));
+					r.align(alignment);
+				}
 
-					[&]<std::size_t... Is>(std::index_sequence<Is...>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
-					{
-						([&]<std::size_t I>(std::in_place_index_t<I>) FOX_SERIALIZE_CONSTEXPR_LAMBDA
-						{
-							if(I == idx)
-							{
-								using c_alternative = std::variant_alternative_t<I, std::variant<Args...>>;
-								using alternative = std::remove_const_t<c_alternative>;
-
-								if constexpr (custom_deserializable_construct<alternative>)
-								{
-									// Construct with reader if possible
-									variant.template emplace<c_alternative>(from_bit_reader, reader);
-								}
-								else
-								{
-									reader | variant.template emplace<c_alternative>();
-								}
-							}
-						}(std::in_place_index<Is>), ...);
-					}(std::index_sequence_for<Args...>{});
+				constexpr std::size_t num_bytes = sizeof(std::ranges::range_value_t<T>) * std::tuple_size_v<T>;
+				co_await reader.need(num_bytes);
+				(void)std::memcpy(static_cast<void*>(std::data(value)), r.read_bytes(num_bytes), num_bytes);
+			}
+			else
+			{
+				for (auto& e : value)
+				{
+					if (auto task = deserialize_or_suspend(reader, e))
+						co_await std::move(*task);
 				}
 			}
-		};
-
-#pragma endregion builtin_variant
-
-#pragma region builtin_optional
-
-		template<class T>
-		struct builtin_serialize_traits<std::optional<T>>
+		}
+		else if constexpr (std::ranges::range<T>)
 		{
-			FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const std::optional<T>& optional)
-				requires is_serializable_v<T>
+			using value_type = typename tuple_like_remove_const<std::ranges::range_value_t<T>>::type;
+
+			if constexpr (is_char_string<T>::value)
 			{
-				writer | optional.has_value();
-				if(optional.has_value())
+				// Strings read with the dictionary aren't encoded as ranges
+				if (r.get_string_dictionary() != nullptr)
 				{
-					writer | optional.value();
+					co_await deserialize_retry_async(reader, value);
+					co_return;
 				}
 			}
 
-			FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, std::optional<T>& optional)
-				requires is_deserializable_v<T>
+			constexpr bool resumable =
+				std::is_default_constructible_v<value_type> &&
+				requires(T& c) { c.clear(); } &&
+				container_insertable<T, value_type&&>;
+
+			if constexpr (resumable)
 			{
-				bool has_value = false;
-				reader | has_value;
-				if(has_value)
+				std::size_t size{};
+				co_await reader.need(sizeof(size));
+				r | size;
+				value.clear();
+
+				// Elements are allocated as they arrive, so the remaining data isn't checked
+				const nesting_guard nesting(r);
+				r.charge(size, sizeof(value_type));
+
+				if constexpr (memcpy_compatible_element<value_type>)
 				{
-					if constexpr (custom_deserializable_construct<T>)
+					if (const std::size_t alignment = std::max(r.alignment(), alignof(value_type)); r.alignment() != 0)
 					{
-						// Construct with reader if possible
-						optional.emplace(from_bit_reader, reader);
+						co_await reader.need(r.padding(alignment));
+						r.align(alignment);
 					}
-					else
+				}
+
+				constexpr bool memcpy_compatible =
+					memcpy_compatible_element<value_type> &&
+					std::ranges::contiguous_range<T> &&
+					requires(T& c, std::size_t n) { c.resize(n); };
+
+				if constexpr (memcpy_compatible)
+				{
+					// Copy elements in chunks, as they arrive
+					for (std::size_t left = size; left > 0;)
 					{
-						reader | optional.emplace();
+						co_await reader.need(sizeof(value_type));
+						const std::size_t count = std::min(left, r.remaining() / sizeof(value_type));
+						const std::size_t old_size = std::size(value);
+						value.resize(old_size + count);
+						(void)std::memcpy(static_cast<void*>(std::data(value) + old_size), r.read_bytes(sizeof(value_type) * count), sizeof(value_type) * count);
+						left -= count;
 					}
 				}
 				else
 				{
-					optional.reset();
+					for (std::size_t i = 0; i < size; ++i)
+					{
+						value_type v{};
+						if constexpr (memcpy_compatible_element<value_type>)
+						{
+							// Elements are stored as object bytes, like in the synchronous deserialization
+							co_await reader.need(sizeof(value_type));
+							(void)std::memcpy(static_cast<void*>(std::addressof(v)), r.read_bytes(sizeof(value_type)), sizeof(value_type));
+						}
+						else if (auto task = deserialize_or_suspend(reader, v))
+						{
+							co_await std::move(*task);
+						}
+
+						if constexpr (requires { value.push_back(std::move(v)); })
+							value.push_back(std::move(v));
+						else
+							value.insert(std::end(value), std::move(v));
+					}
 				}
+			}
+			else
+			{
+				co_await deserialize_retry_async(reader, value);
+			}
+		}
+		else if constexpr (tuple_like<T>)
+		{
+			co_await deserialize_tuple_async(reader, value);
+		}
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+		else if constexpr (::fox::reflexpr::aggregate<T>)
+		{
+			using members = typename presence_members_of<decltype(fox::reflexpr::tie(std::declval<T&>()))>::type;
+			auto tie = fox::reflexpr::tie(value);
+
+			if constexpr (members::optional_count == 0)
+				co_await deserialize_tuple_async(reader, tie);
+			else
+				co_await deserialize_retry_async(reader, value);
+		}
+#endif
+		else
+		{
+			co_await deserialize_retry_async(reader, value);
+		}
+	}
+
+	/**
+	 * \brief Status of the async_decoder.
+	 */
+	enum class decode_status
+	{
+		complete,
+		need_more
+	};
+
+	/**
+	 * \brief Resumable deserializer for the data that arrives in parts, for example from a non-blocking socket.
+	 * Deserialization continues from where it stopped when more data is fed.
+	 * \tparam T Type of the object to deserialize
+	 */
+	template<class T>
+	class async_decoder
+	{
+		static_assert(std::is_default_constructible_v<T>, "[T] is not default constructible.");
+
+		async_reader reader_;
+		T value_{};
+		decode_task task_;
+		bool started_ = false;
+
+	public:
+		/**
+		 * \brief Constructs async_decoder waiting for the data.
+		 */
+		async_decoder()
+			: task_(deserialize_async(reader_, value_)) {}
+
+		/**
+		 * \brief Constructs async_decoder waiting for the data with the given memory resource.
+		 * \param mr Memory resource to construct async_reader with.
+		 */
+		explicit async_decoder(std::pmr::memory_resource* mr)
+			: reader_(mr), task_(deserialize_async(reader_, value_)) {}
+
+		async_decoder(const async_decoder&) = delete;
+		async_decoder& operator=(const async_decoder&) = delete;
+
+	public:
+		/**
+		 * \brief Sets limits of resources deserialization may use. Refer to bit_reader::set_limits.
+		 * \param limits Limits to use.
+		 */
+		void set_limits(const decode_limits& limits) noexcept
+		{
+			reader_.reader().set_limits(limits);
+		}
+
+		/**
+		 * \brief Enables the aligned layout. Refer to bit_reader::set_alignment.
+		 * \param alignment Power of two, 1 aligns to alignof(T), 0 disables padding.
+		 */
+		void set_alignment(std::size_t alignment)
+		{
+			reader_.reader().set_alignment(alignment);
+		}
+
+		/**
+		 * \brief Appends received data and continues deserialization.
+		 * \param bytes Received serialized data.
+		 * \return decode_status::complete if the object was deserialized, decode_status::need_more otherwise.
+		 */
+		decode_status feed(std::span<const std::byte> bytes)
+		{
+			if (done())
+				return decode_status::complete;
+
+			reader_.append(bytes);
 
+			if (!started_)
+			{
+				started_ = true;
+				task_.handle_.resume();
+			}
+			else
+			{
+				(void)reader_.resume();
 			}
-		};
 
-#pragma endregion builtin_variant
+			if (!done())
+				return decode_status::need_more;
 
-		template<class C, class Member>
-		struct is_member_object_pointer_of : std::false_type {};
+			if (task_.handle_.promise().exception)
+				std::rethrow_exception(task_.handle_.promise().exception);
 
-		template<class C, class T>
-		struct is_member_object_pointer_of<C, T C::*> : std::true_type {};
+			return decode_status::complete;
+		}
 
-		template<class T>
-		struct remove_member_pointer;
+		/**
+		 * \brief Checks if the object was deserialized.
+		 */
+		[[nodiscard]] bool done() const noexcept
+		{
+			return task_.handle_.done();
+		}
 
-		template<class C, class T>
-		struct remove_member_pointer<T C::*>
+		/**
+		 * \brief Number of bytes required to continue deserialization. It's a lower bound, more may be needed after that.
+		 */
+		[[nodiscard]] std::size_t bytes_needed() const noexcept
 		{
-			using type = T;
-		};
-	}
+			return started_ ? reader_.bytes_needed() : 1;
+		}
 
-	/**
-	 * \brief Helper class providing serialization trait from the members. Refer samples/sample_custom_4.cpp
-	 * \tparam T Object type
-	 * \tparam Members Member list
-	 */
-	template<class T, auto... Members> requires
-		std::conjunction_v<::fox::serialize::details::is_member_object_pointer_of<T, decltype(Members)>...>
-	struct serialize_from_members
-	{
-		FOX_SERIALIZE_INLINE static void serialize(bit_writer& writer, const T& v)
-			requires std::conjunction_v<::fox::serialize::is_serializable<typename ::fox::serialize::details::remove_member_pointer<decltype(Members)>::type>...>
+		/**
+		 * \brief Deserialized object, complete once done() returns true.
+		 */
+		[[nodiscard]] T& value() noexcept
 		{
-			((writer | (v.*Members)), ...);
+			return value_;
 		}
 
-		FOX_SERIALIZE_INLINE static void deserialize(bit_reader& reader, T& v)
-			requires std::conjunction_v<::fox::serialize::is_deserializable<typename ::fox::serialize::details::remove_member_pointer<decltype(Members)>::type>...>
+		/**
+		 * \brief Data that was fed past the end of the deserialized object.
+		 */
+		[[nodiscard]] std::span<const std::byte> unconsumed() noexcept
 		{
-			((reader | (v.*Members)), ...);
+			bit_reader& r = reader_.reader();
+			return { static_cast<const std::byte*>(r.read_bytes(0)), r.remaining() };
 		}
 	};
+#pragma endregion async
 }
 
 #endif
@@ -0,0 +1,868 @@
+/// This header is distributed under MIT license.
+///
+/// Author:			Marcin Poloczek (aka. RedSkittleFox)
+///	Contact:		RedSkittleFox@gmail.com
+/// Copyright:		Marcin Poloczek
+/// License:		MIT
+/// Version:		1.0.0
+///
+#ifndef FOX_SERIALIZE_IO_H_
+#define FOX_SERIALIZE_IO_H_
+#pragma once
+
+#include <fox/serialize.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <filesystem>
+#include <system_error>
+
+#if __has_include(<unistd.h>) && __has_include(<sys/mman.h>)
+#define FOX_SERIALIZE_POSIX_FILES
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fox::serialize
+{
+#pragma region page_storage
+	/**
+	 * \brief Growable storage of anonymous memory pages. On Linux it grows with mremap, which moves the pages instead of
+	 * copying the bytes, and release returns the written pages to the system with madvise(MADV_DONTNEED).
+	 * On other systems it grows with std::realloc.
+	 */
+	class page_storage : public growable_storage
+	{
+		std::byte* data_ = nullptr;
+		std::size_t capacity_ = 0;
+
+	public:
+		/**
+		 * \brief Constructs page_storage.
+		 * \param initial_capacity Number of bytes to allocate upfront.
+		 * \throws std::bad_alloc if the memory can't be allocated
+		 */
+		explicit page_storage(std::size_t initial_capacity = 0)
+		{
+			if (initial_capacity != 0)
+				(void)grow(initial_capacity);
+		}
+
+		// bit_writer keeps a pointer to the storage
+		page_storage(const page_storage&) = delete;
+		page_storage& operator=(const page_storage&) = delete;
+
+		~page_storage() override
+		{
+			if (data_ == nullptr)
+				return;
+
+#if defined(__linux__)
+			(void)::munmap(data_, capacity_);
+#else
+			std::free(data_);
+#endif
+		}
+
+	public:
+		[[nodiscard]] std::span<std::byte> storage() noexcept override
+		{
+			return { data_, capacity_ };
+		}
+
+		[[nodiscard]] std::span<std::byte> grow(std::size_t required) override
+		{
+			if (required <= capacity_)
+				return storage();
+
+			constexpr std::size_t min_capacity = 64 * 1024;
+			std::size_t capacity = std::max({ required, capacity_ * 2, min_capacity });
+
+#if defined(__linux__)
+			const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+			if (capacity > std::numeric_limits<std::size_t>::max() - page)
+				throw std::bad_alloc();
+			capacity = (capacity + page - 1) / page * page;
+
+			void* data = data_ == nullptr ?
+				::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) :
+				::mremap(data_, capacity_, capacity, MREMAP_MAYMOVE);
+			if (data == MAP_FAILED)
+				throw std::bad_alloc();
+#else
+			void* data = std::realloc(data_, capacity);
+			if (data == nullptr)
+				throw std::bad_alloc();
+#endif
+			data_ = static_cast<std::byte*>(data);
+			capacity_ = capacity;
+			return storage();
+		}
+
+		void release([[maybe_unused]] std::size_t used) noexcept override
+		{
+#if defined(__linux__)
+			// Pages read as zeroes on the next access, the virtual range is kept
+			if (used != 0)
+				(void)::madvise(data_, std::min(used, capacity_), MADV_DONTNEED);
+#endif
+		}
+
+		/**
+		 * \brief Number of bytes of the storage.
+		 */
+		[[nodiscard]] std::size_t capacity() const noexcept
+		{
+			return capacity_;
+		}
+	};
+#pragma endregion page_storage
+
+#pragma region record_log
+	namespace details
+	{
+		struct file_deleter
+		{
+			void operator()(std::FILE* file) const noexcept
+			{
+				(void)std::fclose(file);
+			}
+		};
+
+		[[nodiscard]] inline std::FILE* open_file(const std::filesystem::path& path, const char* mode)
+		{
+#if defined(_MSC_VER)
+			std::FILE* file = nullptr;
+			(void)::fopen_s(&file, path.string().c_str(), mode);
+#else
+			std::FILE* file = std::fopen(path.string().c_str(), mode);
+#endif
+			if (file == nullptr)
+				throw std::system_error(errno, std::generic_category(), std::format("Failed to open {}", path.string()));
+			return file;
+		}
+	}
+
+	/**
+	 * \brief Read-only view of a file's contents. On POSIX systems the file is memory mapped for sequential access,
+	 * on other systems it is read into memory.
+	 */
+	class mapped_file
+	{
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+		void* data_ = nullptr;
+		std::size_t size_ = 0;
+#else
+		std::vector<std::byte> data_;
+#endif
+
+	public:
+		mapped_file() noexcept = default;
+
+		/**
+		 * \brief Maps the file.
+		 * \param path Path of the file
+		 * \throws std::system_error if the file can't be opened or mapped
+		 */
+		explicit mapped_file(const std::filesystem::path& path)
+		{
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::system_error(errno, std::system_category(), std::format("Failed to open {}", path.string()));
+
+			struct stat info{};
+			if (::fstat(fd, &info) != 0)
+			{
+				const int error = errno;
+				(void)::close(fd);
+				throw std::system_error(error, std::system_category(), std::format("Failed to stat {}", path.string()));
+			}
+
+			size_ = static_cast<std::size_t>(info.st_size);
+			if (size_ != 0)
+			{
+				data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data_ == MAP_FAILED)
+				{
+					const int error = errno;
+					data_ = nullptr;
+					(void)::close(fd);
+					throw std::system_error(error, std::system_category(), std::format("Failed to map {}", path.string()));
+				}
+				(void)::madvise(data_, size_, MADV_SEQUENTIAL);
+			}
+			(void)::close(fd);
+#else
+			std::unique_ptr<std::FILE, ::fox::serialize::details::file_deleter> file(::fox::serialize::details::open_file(path, "rb"));
+			data_.resize(static_cast<std::size_t>(std::filesystem::file_size(path)));
+			if (std::fread(std::data(data_), 1, std::size(data_), file.get()) != std::size(data_))
+				throw std::system_error(errno, std::generic_category(), std::format("Failed to read {}", path.string()));
+#endif
+		}
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		mapped_file(mapped_file&& other) noexcept
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+			: data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+#else
+			: data_(std::move(other.data_)) {}
+#endif
+
+		mapped_file& operator=(mapped_file&& other) noexcept
+		{
+			if (this != &other)
+			{
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+				unmap();
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+#else
+				data_ = std::move(other.data_);
+#endif
+			}
+			return *this;
+		}
+
+		~mapped_file()
+		{
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+			unmap();
+#endif
+		}
+
+	public:
+		/**
+		 * \brief Contents of the file.
+		 */
+		[[nodiscard]] std::span<const std::byte> bytes() const noexcept
+		{
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+			return { static_cast<const std::byte*>(data_), size_ };
+#else
+			return data_;
+#endif
+		}
+
+	private:
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+		void unmap() noexcept
+		{
+			if (data_ != nullptr)
+				(void)::munmap(data_, size_);
+		}
+#endif
+	};
+
+	/**
+	 * \brief Record read from the record log. Payload points into the log's bytes.
+	 */
+	struct log_record
+	{
+		std::uint64_t number;
+		std::span<const std::byte> payload;
+	};
+
+	namespace details
+	{
+		// Log starts with the magic. Every entry is a frame whose payload starts with its kind.
+		// Index blocks are preceded by a marker, so the last one can be found from the end of the log.
+		// Record frames can't start with the marker, as their kind follows the payload length.
+		inline constexpr std::array<char, 8> record_log_magic = { 'F', 'X', 'R', 'L', 'O', 'G', '0', '1' };
+		inline constexpr std::array<char, 8> record_log_index_marker = { 'F', 'X', 'R', 'L', 'I', 'D', 'X', '1' };
+
+		enum class record_log_entry : std::uint8_t
+		{
+			record,
+			index
+		};
+
+		constexpr std::uint64_t record_log_no_index = std::numeric_limits<std::uint64_t>::max();
+
+		// Index block: its own offset, offset of the previous block, range of the records it covers
+		// and pairs of record number and offset of every index_stride-th record since the previous block
+		struct record_log_index
+		{
+			std::uint64_t self = 0;
+			std::uint64_t previous = record_log_no_index;
+			std::uint64_t first_record = 0;
+			std::uint64_t end_record = 0;
+			std::vector<std::pair<std::uint64_t, std::uint64_t>> entries;
+		};
+
+		[[nodiscard]] inline bool has_record_log_marker(std::span<const std::byte> bytes, std::size_t offset) noexcept
+		{
+			return offset <= std::size(bytes) && std::size(bytes) - offset >= std::size(record_log_index_marker) &&
+				std::memcmp(std::data(bytes) + offset, std::data(record_log_index_marker), std::size(record_log_index_marker)) == 0;
+		}
+
+		// Parses the index block at offset, std::nullopt if there isn't a valid one
+		[[nodiscard]] inline std::optional<std::pair<record_log_index, std::size_t>> parse_record_log_index(std::span<const std::byte> bytes, std::size_t offset)
+		{
+			if (!has_record_log_marker(bytes, offset))
+				return std::nullopt;
+
+			std::optional<frame> f;
+			try
+			{
+				f = try_parse_frame(bytes.subspan(offset + std::size(record_log_index_marker)));
+			}
+			catch (const std::invalid_argument&)
+			{
+				return std::nullopt;
+			}
+
+			if (!f.has_value() || std::empty(f->payload) || f->payload[0] != static_cast<std::byte>(record_log_entry::index))
+				return std::nullopt;
+
+			bit_reader reader(std::from_range, f->payload.subspan(1));
+			record_log_index index;
+			reader | index.self | index.previous | index.first_record | index.end_record | index.entries;
+			if (index.self != offset)
+				return std::nullopt;
+
+			return std::pair{ std::move(index), std::size(record_log_index_marker) + f->size };
+		}
+	}
+
+	/**
+	 * \brief Reader of the log written with record_log_writer. Supports seeking to a record in O(log n) using the sparse index
+	 * and sequential iteration. Data past the last complete record, e.g. a torn write, is ignored.
+	 */
+	class record_log_reader
+	{
+		friend class record_log_writer;
+
+		std::span<const std::byte> bytes_;
+
+		// Number of the first record covered by every index block and offset of the block
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> blocks_;
+
+		// Offsets of records following the last index block
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> tail_;
+
+		std::uint64_t size_ = 0;
+		std::size_t valid_size_ = 0;
+
+	public:
+		class iterator
+		{
+			const record_log_reader* log_ = nullptr;
+			std::size_t position_ = 0;
+			std::size_t next_ = 0;
+			log_record current_{};
+
+		public:
+			using value_type = log_record;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			iterator(const record_log_reader* log, std::size_t position, std::uint64_t number)
+				: log_(log), next_(position), current_{ number, {} }
+			{
+				advance();
+			}
+
+			[[nodiscard]] const log_record& operator*() const noexcept { return current_; }
+			[[nodiscard]] const log_record* operator->() const noexcept { return std::addressof(current_); }
+
+			iterator& operator++()
+			{
+				++current_.number;
+				advance();
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				iterator it = *this;
+				++*this;
+				return it;
+			}
+
+			/**
+			 * \brief Offset of the current record in the log.
+			 */
+			[[nodiscard]] std::size_t offset() const noexcept { return position_; }
+
+			[[nodiscard]] friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+			{
+				return lhs.position_ == rhs.position_;
+			}
+
+			[[nodiscard]] friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+			{
+				return it.log_ == nullptr || it.position_ >= it.log_->valid_size();
+			}
+
+		private:
+			// Frames were checked when the log was opened, a missing one means the index points into the middle of a frame
+			[[nodiscard]] static frame frame_at(std::span<const std::byte> bytes, std::size_t offset)
+			{
+				const std::optional<frame> f = try_parse_frame(bytes.subspan(offset));
+				if (!f.has_value())
+					throw std::invalid_argument(std::format("Record log has no complete frame at offset {}.", offset));
+
+				return *f;
+			}
+
+			// Moves to the next record frame, skipping index blocks
+			void advance()
+			{
+				const std::span<const std::byte> bytes = log_->bytes_.first(log_->valid_size_);
+				while (next_ < std::size(bytes))
+				{
+					if (::fox::serialize::details::has_record_log_marker(bytes, next_))
+					{
+						next_ += std::size(::fox::serialize::details::record_log_index_marker);
+						next_ += frame_at(bytes, next_).size;
+						continue;
+					}
+
+					const frame f = frame_at(bytes, next_);
+					position_ = next_;
+					next_ += f.size;
+					current_.payload = f.payload.subspan(1);
+					return;
+				}
+				position_ = next_;
+			}
+		};
+
+		record_log_reader() noexcept = default;
+
+		/**
+		 * \brief Opens the log stored in the bytes, e.g. mapped_file::bytes(). The bytes have to outlive the reader.
+		 * Index blocks are found starting from the end of the log, only records following the last one are scanned.
+		 * \param bytes Contents of the log
+		 * \throws std::invalid_argument if the bytes don't start with the record log header
+		 */
+		explicit record_log_reader(std::span<const std::byte> bytes)
+			: bytes_(bytes)
+		{
+			using namespace ::fox::serialize::details;
+
+			if (std::size(bytes_) < std::size(record_log_magic) ||
+				std::memcmp(std::data(bytes_), std::data(record_log_magic), std::size(record_log_magic)) != 0)
+				throw std::invalid_argument("Data isn't a record log.");
+
+			// Marker can also appear in the record payloads, candidates are validated by the checksum and the offset they store
+			std::optional<std::pair<record_log_index, std::size_t>> last;
+			auto search_end = std::end(bytes_);
+			while (!last.has_value())
+			{
+				const auto found = std::ranges::find_end(std::begin(bytes_) + std::size(record_log_magic), search_end,
+					std::begin(record_log_index_marker), std::end(record_log_index_marker),
+					[](std::byte b, char c) { return b == static_cast<std::byte>(c); });
+
+				if (std::empty(found))
+					break;
+
+				last = parse_record_log_index(bytes_, static_cast<std::size_t>(std::begin(found) - std::begin(bytes_)));
+				search_end = std::end(found) - 1;
+			}
+
+			std::size_t tail_offset = std::size(record_log_magic);
+			std::uint64_t tail_record = 0;
+			if (last.has_value())
+			{
+				tail_offset = static_cast<std::size_t>(last->first.self) + last->second;
+				tail_record = last->first.end_record;
+
+				std::uint64_t previous = last->first.previous;
+				blocks_.emplace_back(last->first.first_record, last->first.self);
+				while (previous != record_log_no_index)
+				{
+					auto block = parse_record_log_index(bytes_, static_cast<std::size_t>(previous));
+					if (!block.has_value())
+						throw std::invalid_argument(std::format("Invalid record log index block at {}.", previous));
+
+					blocks_.emplace_back(block->first.first_record, block->first.self);
+					previous = block->first.previous;
+				}
+				std::ranges::reverse(blocks_);
+			}
+
+			scan_tail(tail_offset, tail_record);
+		}
+
+	public:
+		/**
+		 * \brief Number of records.
+		 */
+		[[nodiscard]] std::uint64_t size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * \brief Checks if the log has no records.
+		 */
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return size_ == 0;
+		}
+
+		/**
+		 * \brief Number of bytes up to the end of the last complete record.
+		 */
+		[[nodiscard]] std::size_t valid_size() const noexcept
+		{
+			return valid_size_;
+		}
+
+		[[nodiscard]] iterator begin() const
+		{
+			return iterator(this, std::size(::fox::serialize::details::record_log_magic), 0);
+		}
+
+		[[nodiscard]] std::default_sentinel_t end() const noexcept
+		{
+			return std::default_sentinel;
+		}
+
+		/**
+		 * \brief Returns iterator to the record, following records can be read by incrementing it.
+		 * The index block covering the record is found with a binary search, then at most index_stride records are skipped.
+		 * \param number Number of the record
+		 * \return Iterator to the record or equal to end() if number isn't smaller than size()
+		 */
+		[[nodiscard]] iterator seek(std::uint64_t number) const
+		{
+			if (number >= size_)
+				return iterator(this, valid_size_, size_);
+
+			std::pair<std::uint64_t, std::uint64_t> entry;
+			if (!std::empty(tail_) && number >= tail_.front().first)
+			{
+				entry = tail_[static_cast<std::size_t>(number - tail_.front().first)];
+			}
+			else
+			{
+				const auto block = std::ranges::upper_bound(blocks_, number, {}, &std::pair<std::uint64_t, std::uint64_t>::first) - 1;
+				const auto index = ::fox::serialize::details::parse_record_log_index(bytes_, static_cast<std::size_t>(block->second));
+				if (!index.has_value())
+					throw std::invalid_argument(std::format("Invalid record log index block at {}.", block->second));
+
+				const auto& entries = index->first.entries;
+				entry = *(std::ranges::upper_bound(entries, number, {}, &std::pair<std::uint64_t, std::uint64_t>::first) - 1);
+			}
+
+			iterator it(this, static_cast<std::size_t>(entry.second), entry.first);
+			for (std::uint64_t n = entry.first; n < number; ++n)
+				++it;
+			return it;
+		}
+
+	private:
+		void scan_tail(std::size_t offset, std::uint64_t number)
+		{
+			valid_size_ = offset;
+			while (offset < std::size(bytes_))
+			{
+				std::optional<frame> f;
+				try
+				{
+					f = try_parse_frame(bytes_.subspan(offset));
+				}
+				catch (const std::invalid_argument&)
+				{
+					// Torn write
+					break;
+				}
+
+				if (!f.has_value() || std::empty(f->payload) || f->payload[0] != static_cast<std::byte>(::fox::serialize::details::record_log_entry::record))
+					break;
+
+				tail_.emplace_back(number++, offset);
+				offset += f->size;
+				valid_size_ = offset;
+			}
+			size_ = number;
+		}
+	};
+
+	/**
+	 * \brief Options of record_log_writer.
+	 */
+	struct record_log_options
+	{
+		// Number of records between index blocks
+		std::size_t index_interval = 4096;
+
+		// Every index_stride-th record has an entry in the index block, seek skips at most index_stride records
+		std::size_t index_stride = 64;
+
+		// Appended records are written to the file once the batch grows past this size
+		std::size_t batch_size = 64 * 1024;
+
+		// Written data is synced to the storage once this many bytes weren't synced, 0 syncs only with sync()
+		std::size_t sync_size = 0;
+	};
+
+	/**
+	 * \brief Append-only log of records, read with record_log_reader. Records are framed with a checksum and batched in memory,
+	 * every index_interval records a sparse index block mapping record numbers to offsets is written.
+	 */
+	class record_log_writer
+	{
+		std::unique_ptr<std::FILE, ::fox::serialize::details::file_deleter> file_;
+		record_log_options options_;
+		bit_writer batch_;
+
+		std::uint64_t written_ = 0;
+		std::uint64_t unsynced_ = 0;
+		std::uint64_t records_ = 0;
+
+		::fox::serialize::details::record_log_index index_;
+
+	public:
+		/**
+		 * \brief Opens the log for appending, creating it if it doesn't exist. Data following the last complete record
+		 * of the existing log, e.g. a torn write, is truncated.
+		 * \param path Path of the log file
+		 * \param options Options of the writer
+		 * \throws std::invalid_argument if options are invalid or the existing file isn't a record log
+		 * \throws std::system_error if the file can't be opened
+		 */
+		explicit record_log_writer(const std::filesystem::path& path, const record_log_options& options = {})
+			: options_(options)
+		{
+			using namespace ::fox::serialize::details;
+
+			if (options_.index_interval == 0 || options_.index_stride == 0)
+				throw std::invalid_argument("Index interval and stride of the record log have to be greater than zero.");
+
+			std::error_code error;
+			const std::uintmax_t file_size = std::filesystem::file_size(path, error);
+			if (!error && file_size != 0)
+			{
+				std::size_t valid_size;
+				{
+					const mapped_file file(path);
+					const record_log_reader reader(file.bytes());
+
+					valid_size = reader.valid_size();
+					records_ = reader.size();
+					index_.previous = std::empty(reader.blocks_) ? record_log_no_index : reader.blocks_.back().second;
+					index_.first_record = std::empty(reader.tail_) ? records_ : reader.tail_.front().first;
+					for (const auto& [number, offset] : reader.tail_)
+					{
+						if (number == index_.first_record || number % options_.index_stride == 0)
+							index_.entries.emplace_back(number, offset);
+					}
+				}
+
+				if (valid_size != file_size)
+					std::filesystem::resize_file(path, valid_size);
+
+				written_ = valid_size;
+				file_.reset(open_file(path, "ab"));
+			}
+			else
+			{
+				file_.reset(open_file(path, "wb"));
+				write_bytes(std::as_bytes(std::span(record_log_magic)));
+			}
+		}
+
+		record_log_writer(const record_log_writer&) = delete;
+		record_log_writer& operator=(const record_log_writer&) = delete;
+		record_log_writer(record_log_writer&&) noexcept = default;
+
+		/**
+		 * \brief Move assignment operator. Batched records of this writer are written to its file before it's replaced.
+		 * \throws std::system_error if the batched records can't be written
+		 * \return *this
+		 */
+		record_log_writer& operator=(record_log_writer&& other)
+		{
+			if (this != std::addressof(other))
+			{
+				if (file_ != nullptr)
+					flush();
+
+				file_ = std::move(other.file_);
+				options_ = other.options_;
+				batch_ = std::move(other.batch_);
+				written_ = std::exchange(other.written_, 0);
+				unsynced_ = std::exchange(other.unsynced_, 0);
+				records_ = std::exchange(other.records_, 0);
+				index_ = std::move(other.index_);
+			}
+			return *this;
+		}
+
+		/**
+		 * \brief Writes the batched records to the file.
+		 */
+		~record_log_writer()
+		{
+			if (file_ != nullptr)
+			{
+				try
+				{
+					flush();
+				}
+				catch (...) {}
+			}
+		}
+
+	public:
+		/**
+		 * \brief Serializes values into a single record.
+		 * \param values Values to serialize
+		 * \return Number of the record
+		 */
+		template<serializable... Ts>
+		std::uint64_t append(const Ts&... values)
+		{
+			auto payload = acquire_writer();
+			*payload | ::fox::serialize::details::record_log_entry::record;
+			((*payload | values), ...);
+			return append_frame(payload->data());
+		}
+
+		/**
+		 * \brief Appends the bytes as a single record.
+		 * \param bytes Payload of the record
+		 * \return Number of the record
+		 */
+		std::uint64_t append_bytes(std::span<const std::byte> bytes)
+		{
+			auto payload = acquire_writer();
+			*payload | ::fox::serialize::details::record_log_entry::record;
+			payload->write_bytes(std::data(bytes), std::size(bytes));
+			return append_frame(payload->data());
+		}
+
+		/**
+		 * \brief Writes the batched records to the file. Data is synced if sync_size bytes weren't synced.
+		 * \throws std::system_error if the data can't be written
+		 */
+		void flush()
+		{
+			if (!std::empty(batch_.data()))
+			{
+				const std::span<const std::byte> data = batch_.data();
+				if (std::fwrite(std::data(data), 1, std::size(data), file_.get()) != std::size(data))
+					throw std::system_error(errno, std::generic_category(), "Failed to write the record log");
+
+				unsynced_ += std::size(data);
+				batch_.clear();
+			}
+
+			if (std::fflush(file_.get()) != 0)
+				throw std::system_error(errno, std::generic_category(), "Failed to write the record log");
+
+			if (options_.sync_size != 0 && unsynced_ >= options_.sync_size)
+				sync_file();
+		}
+
+		/**
+		 * \brief Writes the batched records and syncs the file to the storage, all records appended before are durable.
+		 * Syncing after a group of records amortizes its cost.
+		 * \throws std::system_error if the data can't be written or synced
+		 */
+		void sync()
+		{
+			flush();
+			if (unsynced_ != 0)
+				sync_file();
+		}
+
+		/**
+		 * \brief Number of records in the log.
+		 */
+		[[nodiscard]] std::uint64_t size() const noexcept
+		{
+			return records_;
+		}
+
+		/**
+		 * \brief Number of bytes of the log, including the batched records.
+		 */
+		[[nodiscard]] std::uint64_t size_bytes() const noexcept
+		{
+			return written_;
+		}
+
+	private:
+		std::uint64_t append_frame(std::span<const std::byte> payload)
+		{
+			const std::uint64_t number = records_++;
+			if (number == index_.first_record || number % options_.index_stride == 0)
+				index_.entries.emplace_back(number, written_);
+
+			write_frame_bytes(payload);
+
+			if (records_ - index_.first_record >= options_.index_interval)
+				write_index();
+
+			if (batch_.size() >= options_.batch_size)
+				flush();
+
+			return number;
+		}
+
+		void write_index()
+		{
+			using namespace ::fox::serialize::details;
+
+			index_.self = written_;
+			index_.end_record = records_;
+			auto payload = acquire_writer();
+			*payload | record_log_entry::index | index_.self | index_.previous | index_.first_record | index_.end_record | index_.entries;
+
+			write_bytes(std::as_bytes(std::span(record_log_index_marker)));
+			write_frame_bytes(payload->data());
+
+			index_.previous = index_.self;
+			index_.first_record = records_;
+			index_.entries.clear();
+		}
+
+		void write_frame_bytes(std::span<const std::byte> payload)
+		{
+			const std::size_t before = batch_.size();
+			write_frame(batch_, payload);
+			written_ += batch_.size() - before;
+		}
+
+		void write_bytes(std::span<const std::byte> bytes)
+		{
+			batch_.write_bytes(std::data(bytes), std::size(bytes));
+			written_ += std::size(bytes);
+		}
+
+		void sync_file()
+		{
+#if defined(FOX_SERIALIZE_POSIX_FILES)
+			if (::fsync(::fileno(file_.get())) != 0)
+#elif defined(_WIN32)
+			if (::_commit(::_fileno(file_.get())) != 0)
+#else
+			if (false)
+#endif
+				throw std::system_error(errno, std::generic_category(), "Failed to sync the record log");
+
+			unsynced_ = 0;
+		}
+	};
+#pragma endregion record_log
+}
+
+#endif
@@ -5,6 +5,7 @@ void sample_custom_1();
 void sample_custom_2();
 void sample_custom_3();
 void sample_custom_4();
+void sample_instrumentation();
 void sample_trivial_types();
 
 int main()
@@ -16,6 +17,7 @@ int main()
 	sample_custom_2();
 	sample_custom_3();
 	sample_custom_4();
+	sample_instrumentation();
 	sample_trivial_types();
 	return 0;
 }
\ No newline at end of file
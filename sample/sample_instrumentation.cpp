@@ -0,0 +1,81 @@
+#include <fox/serialize.hpp>
+
+#include <iostream>
+#include <format>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#ifdef FOX_SERIALIZE_INSTRUMENTATION
+
+// Accumulates bytes, calls and cycles for every nesting path
+class top_n_report_sink : public fox::serialize::instrumentation_sink
+{
+	struct entry
+	{
+		std::size_t bytes = 0;
+		std::size_t calls = 0;
+		std::uint64_t cycles = 0;
+	};
+
+	std::map<std::string, entry> entries_;
+
+public:
+	void record(const fox::serialize::instrumentation_event& event) override
+	{
+		std::string path;
+		for (std::string_view type : event.path)
+		{
+			if (!path.empty())
+				path += " / ";
+			path += type;
+		}
+
+		entry& e = entries_[path];
+		e.bytes += event.bytes;
+		e.calls += 1;
+		e.cycles += event.cycles;
+	}
+
+	[[nodiscard]] bool measure_cycles() const noexcept override
+	{
+		return true;
+	}
+
+	void print(std::size_t n) const
+	{
+		std::vector<std::pair<std::string, entry>> sorted(entries_.begin(), entries_.end());
+		std::ranges::sort(sorted, std::ranges::greater{}, [](const auto& p) { return p.second.bytes; });
+
+		for (auto&& [path, e] : sorted | std::views::take(n))
+			std::cout << std::format("{:>8} B {:>6} calls {:>10} cycles  {}\n", e.bytes, e.calls, e.cycles, path);
+	}
+};
+
+void sample_instrumentation()
+{
+	std::vector<std::pair<std::string, std::vector<float>>> events;
+	for (int i = 0; i < 16; ++i)
+		events.emplace_back(std::format("sensor-{}", i), std::vector<float>(static_cast<std::size_t>(i) * 8, 1.f));
+
+	top_n_report_sink sink;
+	auto previous = fox::serialize::set_instrumentation_sink(&sink);
+
+	fox::serialize::bit_writer writer;
+	writer | events;
+
+	fox::serialize::set_instrumentation_sink(previous);
+
+	std::cout << std::format("=== Instrumentation Sample ===\n");
+	sink.print(5);
+}
+
+#else
+
+void sample_instrumentation()
+{
+	std::cout << std::format("=== Instrumentation Sample ===\nConfigure with FOX_SERIALIZE_INSTRUMENTATION=ON to enable instrumentation.\n");
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <fox/serialize.hpp>
+#include <fox/serialize_io.hpp>
 
 #include <random>
 #include <ranges>
@@ -12,6 +13,15 @@
 #include <string>
 #include <string_view>
 #include <span>
+#include <memory>
+#include <numeric>
+#include <list>
+#include <bitset>
+#include <deque>
+#include <forward_list>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 
 namespace fox::serialize
 {
@@ -30,11 +40,12 @@ namespace fox::serialize
 	{
 		static_assert(std::ranges::borrowed_range<std::vector<int>> == false);
 		using value_type = TypeParam;
-		if constexpr(deserializable<value_type>)
+		if constexpr(deserializable<value_type> && !std::same_as<value_type, std::string_view>)
 		{
 			fox::serialize::bit_writer writer;
 			value_type a = test_trait<value_type>::construct();
 			writer | a;
+			EXPECT_EQ(serialized_size(a), std::size(writer.data()));
 			fox::serialize::bit_reader reader(std::from_range, writer.data());
 			value_type b;
 			reader | b;
@@ -363,4 +374,2216 @@ namespace fox::serialize
 	>;
 
 	INSTANTIATE_TYPED_TEST_SUITE_P(fundamental, serialize_test, types);
-}
\ No newline at end of file
+
+	struct udt_padded_members
+	{
+		char v0_;
+		double v1_;
+		std::int16_t v2_;
+		std::string v3_;
+		int v4_;
+		char v5_;
+
+		[[nodiscard]] bool operator==(const udt_padded_members& rhs) const = default;
+
+		using serialize_trait = serialize_from_members<
+			udt_padded_members,
+			&udt_padded_members::v0_,
+			&udt_padded_members::v1_,
+			&udt_padded_members::v2_,
+			&udt_padded_members::v3_,
+			&udt_padded_members::v4_,
+			&udt_padded_members::v5_
+		>;
+	};
+
+	TEST(serialize_coalesced_members, padding_is_not_serialized)
+	{
+		const udt_padded_members a{ 'a', 1.5, 7, "Foxes", -3, 'z' };
+
+		bit_writer writer;
+		writer | a;
+
+		constexpr std::size_t expected_size =
+			sizeof(char) + sizeof(double) + sizeof(std::int16_t) +
+			sizeof(std::size_t) + 5 +
+			sizeof(int) + sizeof(char);
+		EXPECT_EQ(std::size(writer.data()), expected_size);
+
+		bit_reader reader(std::from_range, writer.data());
+		udt_padded_members b{};
+		reader | b;
+		EXPECT_EQ(a, b);
+	}
+
+	TEST(serialize_coalesced_members, same_wire_format_as_separate_members)
+	{
+		const std::tuple<int, char, float, std::string, double> a{ 1, 'b', 2.5f, "Fox", 4.0 };
+
+		bit_writer coalesced;
+		coalesced | a;
+
+		bit_writer separate;
+		separate | std::get<0>(a) | std::get<1>(a) | std::get<2>(a) | std::get<3>(a) | std::get<4>(a);
+
+		EXPECT_TRUE(std::ranges::equal(coalesced.data(), separate.data()));
+	}
+
+	TEST(serialize_stream_pool, reuses_capacity)
+	{
+		writer_pool pool(64, 1024, 2);
+
+		const void* first_buffer = nullptr;
+		{
+			auto writer = pool.acquire();
+			EXPECT_GE(writer->capacity(), 64u);
+			*writer | std::string("Foxes");
+			first_buffer = std::data(writer->data());
+		}
+		EXPECT_EQ(pool.size(), 1u);
+
+		auto writer = pool.acquire();
+		EXPECT_EQ(pool.size(), 0u);
+		EXPECT_TRUE(std::empty(writer->data()));
+		*writer | 1;
+		EXPECT_EQ(std::data(writer->data()), first_buffer);
+	}
+
+	TEST(serialize_stream_pool, trims_above_high_water_mark)
+	{
+		reader_pool pool(64, 1024, 2);
+		{
+			auto reader = pool.acquire();
+			std::vector<std::byte> bytes(4096);
+			reader->assign(bytes);
+			EXPECT_GE(reader->capacity(), 4096u);
+		}
+
+		auto reader = pool.acquire();
+		EXPECT_LE(reader->capacity(), 1024u);
+		EXPECT_GE(reader->capacity(), 64u);
+	}
+
+	TEST(serialize_stream_pool, thread_local_round_trip)
+	{
+		auto writer = acquire_writer();
+		*writer | std::string("Capybara") | 123;
+
+		auto reader = acquire_reader();
+		reader->assign(writer->data());
+		EXPECT_EQ(deserialize<std::string>(*reader), "Capybara");
+		EXPECT_EQ(deserialize<int>(*reader), 123);
+	}
+
+	TEST(serialize_framing, crc32c_check_value)
+	{
+		const std::string_view check = "123456789";
+		EXPECT_EQ(crc32c(std::as_bytes(std::span(check))), 0xE3069283u);
+		EXPECT_EQ(crc32c(std::as_bytes(std::span(check).subspan(4)), crc32c(std::as_bytes(std::span(check).first(4)))), 0xE3069283u);
+
+		std::vector<std::byte> bytes(1021);
+		std::mt19937 rng(7);
+		for (auto& b : bytes)
+			b = static_cast<std::byte>(rng());
+
+		const std::uint32_t portable = ~details::crc32c_portable(~0u, std::data(bytes), std::size(bytes));
+		EXPECT_EQ(crc32c(bytes), portable);
+	}
+
+	TEST(serialize_framing, round_trip)
+	{
+		bit_writer writer;
+		serialize_frame(writer, std::string("Foxes"), 12);
+		write_frame(writer, {});
+		serialize_frame(writer, std::vector<int>(200, 3));
+
+		std::vector<std::span<const std::byte>> payloads;
+		for (const frame& f : frame_view(writer.data()))
+			payloads.push_back(f.payload);
+
+		ASSERT_EQ(std::size(payloads), 3u);
+		EXPECT_TRUE(std::empty(payloads[1]));
+
+		bit_reader payload(std::from_range, payloads[0]);
+		EXPECT_EQ(deserialize<std::string>(payload), "Foxes");
+		EXPECT_EQ(deserialize<int>(payload), 12);
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(std::size(read_frame(reader)), std::size(payloads[0]));
+		EXPECT_TRUE(std::empty(read_frame(reader)));
+		EXPECT_EQ(std::size(read_frame(reader)), std::size(payloads[2]));
+		EXPECT_THROW((void)read_frame(reader), std::out_of_range);
+	}
+
+	TEST(serialize_framing, incomplete_and_corrupted)
+	{
+		bit_writer writer;
+		serialize_frame(writer, std::string("Capybara"));
+		const auto bytes = writer.data();
+
+		for (std::size_t i = 0; i < std::size(bytes); ++i)
+			EXPECT_FALSE(try_parse_frame(bytes.first(i)).has_value());
+
+		const auto f = try_parse_frame(bytes);
+		ASSERT_TRUE(f.has_value());
+		EXPECT_EQ(f->size, std::size(bytes));
+
+		std::vector<std::byte> corrupted(std::begin(bytes), std::end(bytes));
+		corrupted[3] ^= std::byte{ 1 };
+		EXPECT_THROW((void)try_parse_frame(corrupted), std::invalid_argument);
+	}
+
+	TEST(serialize_framing, non_canonical_length)
+	{
+		// Length 3 encoded in two bytes is still a valid frame
+		std::vector<std::byte> bytes{ std::byte{ 0x83 }, std::byte{ 0x00 }, std::byte{ 'F' }, std::byte{ 'o' }, std::byte{ 'x' } };
+		const std::uint32_t crc = crc32c(bytes);
+		bytes.resize(std::size(bytes) + sizeof(crc));
+		(void)std::memcpy(std::data(bytes) + 5, &crc, sizeof(crc));
+
+		const auto f = try_parse_frame(bytes);
+		ASSERT_TRUE(f.has_value());
+		EXPECT_EQ(f->size, std::size(bytes));
+		ASSERT_EQ(std::size(f->payload), 3u);
+
+		bit_reader reader(std::from_range, std::span<const std::byte>(bytes));
+		const auto payload = read_frame(reader);
+		ASSERT_EQ(std::size(payload), 3u);
+		EXPECT_EQ(payload[0], std::byte{ 'F' });
+		EXPECT_EQ(payload[2], std::byte{ 'x' });
+	}
+
+	using async_message = std::tuple<
+		std::map<std::string, int>,
+		std::vector<double>,
+		std::optional<std::string>,
+		std::variant<int, std::string>,
+		std::array<std::string, 3>,
+		udt_serialize_from_members<0>,
+		std::vector<std::vector<int>>
+	>;
+
+	[[nodiscard]] async_message make_async_message()
+	{
+		return async_message(
+			std::map<std::string, int>{ { "Fox", 1 }, { "Capybara", 2 } },
+			std::vector<double>(100, 1.5),
+			std::optional<std::string>("Foxes can fly"),
+			std::variant<int, std::string>(std::in_place_index<1>, "Foxes"),
+			std::array<std::string, 3>{ "a", "bb", "ccc" },
+			test_trait<udt_serialize_from_members<0>>::construct(),
+			std::vector<std::vector<int>>{ { 1, 2 }, {}, { 3 } }
+		);
+	}
+
+	TEST(serialize_async, byte_by_byte)
+	{
+		const async_message a = make_async_message();
+		bit_writer writer;
+		writer | a;
+		const auto bytes = writer.data();
+
+		async_decoder<async_message> decoder;
+		for (std::size_t i = 0; i + 1 < std::size(bytes); ++i)
+		{
+			ASSERT_EQ(decoder.feed(bytes.subspan(i, 1)), decode_status::need_more);
+			EXPECT_GE(decoder.bytes_needed(), 1u);
+		}
+
+		ASSERT_EQ(decoder.feed(bytes.last(1)), decode_status::complete);
+		EXPECT_EQ(decoder.value(), a);
+		EXPECT_TRUE(std::empty(decoder.unconsumed()));
+	}
+
+	TEST(serialize_async, chunks)
+	{
+		const async_message a = make_async_message();
+		bit_writer writer;
+		writer | a | 7;
+		const auto bytes = writer.data();
+
+		async_decoder<async_message> decoder;
+		std::size_t offset = 0;
+		decode_status status = decode_status::need_more;
+		for (std::size_t chunk = 1; status == decode_status::need_more; chunk += 3)
+		{
+			const std::size_t count = std::min(chunk, std::size(bytes) - offset);
+			status = decoder.feed(bytes.subspan(offset, count));
+			offset += count;
+		}
+
+		EXPECT_EQ(decoder.value(), a);
+
+		bit_reader rest(std::from_range, decoder.unconsumed());
+		EXPECT_EQ(deserialize<int>(rest), 7);
+	}
+
+	TEST(serialize_async, reports_missing_bytes)
+	{
+		bit_writer writer;
+		writer | std::string("Foxes");
+		const auto bytes = writer.data();
+
+		async_decoder<std::string> decoder;
+		EXPECT_EQ(decoder.feed(bytes.first(3)), decode_status::need_more);
+		EXPECT_EQ(decoder.bytes_needed(), sizeof(std::size_t) - 3);
+		EXPECT_EQ(decoder.feed(bytes.subspan(3, sizeof(std::size_t) - 3)), decode_status::need_more);
+		EXPECT_EQ(decoder.bytes_needed(), 1u);
+		EXPECT_EQ(decoder.feed(bytes.subspan(sizeof(std::size_t))), decode_status::complete);
+		EXPECT_EQ(decoder.value(), "Foxes");
+	}
+
+	TEST(serialize_async, memcpy_compatible_elements)
+	{
+		// Trivially copyable elements with their own trait are stored as object bytes in ranges, both decoders have to agree
+		using message = std::tuple<std::vector<std::optional<int>>, std::array<std::optional<int>, 3>>;
+		const message a({ 1, std::nullopt, 3 }, { std::nullopt, 5, 6 });
+
+		bit_writer writer;
+		writer | a;
+		const auto bytes = writer.data();
+
+		bit_reader reader(std::from_range, bytes);
+		EXPECT_EQ(deserialize<message>(reader), a);
+
+		async_decoder<message> decoder;
+		for (std::size_t i = 0; i + 1 < std::size(bytes); ++i)
+			ASSERT_EQ(decoder.feed(bytes.subspan(i, 1)), decode_status::need_more);
+		ASSERT_EQ(decoder.feed(bytes.last(1)), decode_status::complete);
+		EXPECT_EQ(decoder.value(), a);
+	}
+
+#ifdef FOX_SERIALIZE_INSTRUMENTATION
+	class recording_sink : public instrumentation_sink
+	{
+	public:
+		std::vector<std::pair<std::vector<std::string>, instrumentation_event>> events;
+
+		void record(const instrumentation_event& event) override
+		{
+			events.emplace_back(std::vector<std::string>(std::begin(event.path), std::end(event.path)), event);
+		}
+	};
+
+	TEST(serialize_instrumentation, reports_bytes_and_paths)
+	{
+		recording_sink sink;
+		auto previous = set_instrumentation_sink(&sink);
+
+		bit_writer writer;
+		writer | std::optional<std::string>("Fox");
+
+		set_instrumentation_sink(previous);
+
+		ASSERT_FALSE(std::empty(sink.events));
+		const auto& [path, outermost] = sink.events.back();
+		EXPECT_EQ(outermost.operation, instrumentation_operation::serialize);
+		EXPECT_EQ(outermost.bytes, std::size(writer.data()));
+		EXPECT_EQ(std::size(path), 1u);
+		EXPECT_NE(outermost.type_name.find("optional"), std::string_view::npos);
+
+		const auto nested = std::ranges::find_if(sink.events, [](const auto& e) { return std::size(e.first) == 2; });
+		ASSERT_NE(nested, std::end(sink.events));
+		EXPECT_EQ(nested->first.front(), path.front());
+
+		sink.events.clear();
+		writer | 1;
+		EXPECT_TRUE(std::empty(sink.events));
+	}
+#endif
+
+	TEST(serialize_serialized_size, static_sizes)
+	{
+		static_assert(static_serialized_size_v<int> == sizeof(int));
+		static_assert(static_serialized_size_v<std::tuple<int, char>> == sizeof(int) + sizeof(char));
+		static_assert(static_serialized_size_v<std::array<std::pair<int, char>, 3>> == sizeof(std::size_t) + 3 * (sizeof(int) + sizeof(char)));
+		static_assert(!static_serialized_size_v<std::string>.has_value());
+		static_assert(!static_serialized_size_v<udt_serialize_from_members<0>>.has_value());
+
+		EXPECT_EQ(serialized_size(1, 'c', std::pair<int, int>{}), 2 * sizeof(int) + sizeof(int) + sizeof(char));
+	}
+
+	TEST(serialize_serialized_size, counts_custom_traits)
+	{
+		const std::vector<udt_serialize_from_members<2>> a(3, test_trait<udt_serialize_from_members<2>>::construct());
+		const std::optional<std::variant<int, std::string>> b(std::in_place, "Foxes");
+
+		bit_writer writer;
+		writer | a | b;
+
+		bit_writer counter(counting_writer);
+		counter | a | b;
+		EXPECT_EQ(counter.size(), std::size(writer.data()));
+		EXPECT_TRUE(std::empty(counter.data()));
+
+		const std::size_t size = serialized_size(a, b);
+		EXPECT_EQ(size, std::size(writer.data()));
+
+		bit_writer reserved;
+		reserved.reserve(size);
+		const auto capacity = reserved.capacity();
+		reserved | a | b;
+		EXPECT_EQ(reserved.capacity(), capacity);
+	}
+
+	TEST(serialize_string_dictionary, deduplicates_strings)
+	{
+		std::vector<std::pair<std::string, int>> a;
+		for (int i = 0; i < 100; ++i)
+			a.emplace_back(i % 2 ? "Foxes are great!" : "Capybaras are great too!", i);
+
+		bit_writer plain;
+		plain | a;
+
+		string_dictionary write_dictionary;
+		bit_writer writer;
+		writer.set_string_dictionary(&write_dictionary);
+		writer | a;
+		EXPECT_EQ(write_dictionary.size(), 2u);
+		EXPECT_LT(std::size(writer.data()) * 3, std::size(plain.data()));
+
+		string_dictionary read_dictionary;
+		bit_reader reader(std::from_range, writer.data());
+		reader.set_string_dictionary(&read_dictionary);
+		std::vector<std::pair<std::string, int>> b;
+		reader | b;
+		EXPECT_EQ(a, b);
+		EXPECT_EQ(read_dictionary.size(), 2u);
+	}
+
+	TEST(serialize_string_dictionary, string_views_share_storage)
+	{
+		const std::vector<std::string> a = { "Fox", "Capybara", "Fox", "", "Capybara" };
+
+		string_dictionary write_dictionary;
+		bit_writer writer;
+		writer.set_string_dictionary(&write_dictionary);
+		writer | a;
+
+		string_dictionary read_dictionary;
+		bit_reader reader(std::from_range, writer.data());
+		reader.set_string_dictionary(&read_dictionary);
+		std::vector<std::string_view> b;
+		reader | b;
+
+		ASSERT_TRUE(std::ranges::equal(a, b));
+		EXPECT_EQ(std::data(b[0]), std::data(b[2]));
+		EXPECT_EQ(std::data(b[1]), std::data(b[4]));
+
+		bit_reader without_dictionary(std::from_range, writer.data());
+		EXPECT_THROW(without_dictionary | b, std::logic_error);
+
+		bit_reader corrupted(std::from_range, std::array<std::uint8_t, 1>{ 7 });
+		corrupted.set_string_dictionary(&read_dictionary);
+		read_dictionary.clear();
+		std::string c;
+		EXPECT_THROW(corrupted | c, std::invalid_argument);
+	}
+
+	struct shared_node
+	{
+		int value = 0;
+		std::shared_ptr<shared_node> next;
+
+		void serialize(bit_writer& writer) const
+		{
+			writer | value | next;
+		}
+
+		void deserialize(bit_reader& reader)
+		{
+			reader | value | next;
+		}
+	};
+
+	TEST(serialize_smart_pointers, preserves_sharing)
+	{
+		const auto shared = std::make_shared<std::string>("Foxes are great!");
+		const std::vector<std::shared_ptr<std::string>> a = { shared, nullptr, shared, std::make_shared<std::string>("Foxes are great!"), shared };
+		const std::unique_ptr<int> u = std::make_unique<int>(5);
+
+		bit_writer writer;
+		writer | a | u | std::unique_ptr<int>{};
+
+		bit_reader reader(std::from_range, writer.data());
+		std::vector<std::shared_ptr<std::string>> b;
+		std::unique_ptr<int> v;
+		std::unique_ptr<int> w = std::make_unique<int>(7);
+		reader | b | v | w;
+
+		ASSERT_EQ(std::size(b), std::size(a));
+		EXPECT_EQ(*b[0], *shared);
+		EXPECT_EQ(b[1], nullptr);
+		EXPECT_EQ(b[0], b[2]);
+		EXPECT_EQ(b[0], b[4]);
+		EXPECT_NE(b[0], b[3]);
+		EXPECT_EQ(*b[3], *shared);
+		EXPECT_EQ(b[0].use_count(), 4);
+		ASSERT_NE(v, nullptr);
+		EXPECT_EQ(*v, 5);
+		EXPECT_EQ(w, nullptr);
+
+		bit_reader corrupted(std::from_range, std::array<std::uint8_t, 1>{ 3 });
+		std::shared_ptr<std::string> c;
+		EXPECT_THROW(corrupted | c, std::invalid_argument);
+	}
+
+	TEST(serialize_smart_pointers, cycles)
+	{
+		auto a = std::make_shared<shared_node>(1);
+		a->next = std::make_shared<shared_node>(2, a);
+
+		bit_writer writer;
+		writer | a;
+		a->next->next.reset();
+
+		bit_reader reader(std::from_range, writer.data());
+		std::shared_ptr<shared_node> b;
+		reader | b;
+		ASSERT_NE(b, nullptr);
+		ASSERT_NE(b->next, nullptr);
+		EXPECT_EQ(b->value, 1);
+		EXPECT_EQ(b->next->value, 2);
+		EXPECT_EQ(b->next->next, b);
+		b->next->next.reset();
+	}
+
+	struct constructed_node
+	{
+		int value = 0;
+		std::shared_ptr<constructed_node> next;
+
+		constructed_node() = default;
+
+		constructed_node(int v, std::shared_ptr<constructed_node> n)
+			: value(v), next(std::move(n)) {}
+
+		constructed_node(from_bit_reader_t, bit_reader& reader)
+		{
+			reader | value | next;
+		}
+
+		void serialize(bit_writer& writer) const
+		{
+			writer | value | next;
+		}
+	};
+
+	TEST(serialize_smart_pointers, constructed_from_reader)
+	{
+		// Objects nested in a pointee constructed from the reader keep the writer's ids
+		using nodes = std::tuple<std::shared_ptr<constructed_node>, std::shared_ptr<constructed_node>, std::shared_ptr<constructed_node>>;
+		const auto inner = std::make_shared<constructed_node>(2, nullptr);
+		const auto outer = std::make_shared<constructed_node>(1, inner);
+		const nodes a(outer, inner, outer);
+
+		bit_writer writer;
+		writer | a;
+
+		bit_reader reader(std::from_range, writer.data());
+		const auto b = deserialize<nodes>(reader);
+		EXPECT_EQ(std::get<0>(b)->next, std::get<1>(b));
+		EXPECT_EQ(std::get<0>(b), std::get<2>(b));
+		EXPECT_EQ(std::get<1>(b)->value, 2);
+
+		// Pointee constructed from the reader doesn't exist while it's read, so cycles through it can't be read
+		auto cyclic = std::make_shared<constructed_node>(1, nullptr);
+		cyclic->next = std::make_shared<constructed_node>(2, cyclic);
+
+		bit_writer cyclic_writer;
+		cyclic_writer | cyclic;
+		cyclic->next->next.reset();
+
+		bit_reader cyclic_reader(std::from_range, cyclic_writer.data());
+		std::shared_ptr<constructed_node> c;
+		EXPECT_THROW(cyclic_reader | c, std::invalid_argument);
+	}
+
+	TEST(serialize_smart_pointers, async)
+	{
+		using message = std::tuple<std::vector<std::shared_ptr<shared_node>>, std::shared_ptr<shared_node>>;
+		const auto shared = std::make_shared<shared_node>(3, std::make_shared<shared_node>(4));
+		const message a({ shared, shared->next, shared }, shared->next);
+
+		bit_writer writer;
+		writer | a;
+		const auto bytes = writer.data();
+
+		async_decoder<message> decoder;
+		for (std::size_t i = 0; i + 1 < std::size(bytes); ++i)
+			ASSERT_EQ(decoder.feed(bytes.subspan(i, 1)), decode_status::need_more);
+		ASSERT_EQ(decoder.feed(bytes.last(1)), decode_status::complete);
+
+		const auto& [b, c] = decoder.value();
+		ASSERT_EQ(std::size(b), 3u);
+		EXPECT_EQ(b[0], b[2]);
+		EXPECT_EQ(b[0]->next, b[1]);
+		EXPECT_EQ(b[1], c);
+		EXPECT_EQ(c->value, 4);
+	}
+
+	TEST(serialize_delta, changed_members)
+	{
+		using state = std::tuple<int, std::string, udt_serialize_from_members<0>, std::vector<std::string>>;
+		const state a(1, "Fox", test_trait<udt_serialize_from_members<0>>::construct(), { "Foxes", "are", "great" });
+
+		state b = a;
+		std::get<0>(b) = 2;
+		std::get<2>(b) = udt_serialize_from_members<0>("Foxes are great!", 2, 12.345f, { 1, 2, 3, 4, 5 }, { "Foxes", "are", "great" });
+
+		bit_writer full;
+		full | b;
+
+		bit_writer writer;
+		serialize_delta(writer, a, b);
+		EXPECT_LT(std::size(writer.data()) * 4, std::size(full.data()));
+
+		bit_reader reader(std::from_range, writer.data());
+		state c = a;
+		apply_delta(reader, c);
+		EXPECT_EQ(b, c);
+		EXPECT_EQ(reader.remaining(), 0u);
+
+		bit_writer unchanged;
+		serialize_delta(unchanged, a, a);
+		EXPECT_EQ(std::size(unchanged.data()), 1u);
+
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+		const udt_aggregate_type d = test_trait<udt_aggregate_type>::construct();
+		udt_aggregate_type e = d;
+		e.v1_ = 7;
+		e.v3_.push_back(6);
+
+		bit_writer aggregate_writer;
+		serialize_delta(aggregate_writer, d, e);
+
+		bit_reader aggregate_reader(std::from_range, aggregate_writer.data());
+		udt_aggregate_type f = d;
+		apply_delta(aggregate_reader, f);
+		EXPECT_EQ(e, f);
+#endif
+	}
+
+	TEST(serialize_delta, range_patch)
+	{
+		std::vector<int> a(1000);
+		std::iota(std::begin(a), std::end(a), 0);
+
+		const auto round_trip = [&](const std::vector<int>& b)
+		{
+			bit_writer writer;
+			serialize_delta(writer, a, b);
+
+			bit_reader reader(std::from_range, writer.data());
+			std::vector<int> c = a;
+			apply_delta(reader, c);
+			EXPECT_EQ(b, c);
+			EXPECT_EQ(reader.remaining(), 0u);
+			return std::size(writer.data());
+		};
+
+		std::vector<int> b = a;
+		b[3] = -1;
+		b[999] = -1;
+		b.push_back(1000);
+		EXPECT_LT(round_trip(b), 32u);
+
+		b.resize(10);
+		EXPECT_LT(round_trip(b), 32u);
+
+		std::ranges::fill(b, 5);
+		b.resize(1000, 5);
+		EXPECT_EQ(round_trip(b), sizeof(bool) + serialized_size(b));
+
+		std::array<int, 4> d = { 1, 2, 3, 4 };
+		bit_writer writer;
+		serialize_delta(writer, d, std::array<int, 4>{ 1, 2, 5, 4 });
+
+		bit_reader reader(std::from_range, writer.data());
+		apply_delta(reader, d);
+		EXPECT_EQ(d, (std::array<int, 4>{ 1, 2, 5, 4 }));
+
+		bit_reader mismatched(std::from_range, writer.data());
+		std::array<int, 2> e{};
+		EXPECT_THROW(apply_delta(mismatched, e), std::invalid_argument);
+	}
+
+	TEST(serialize_external_storage, writes_into_storage)
+	{
+		const auto a = test_trait<udt_serialize_from_members<0>>::construct();
+		bit_writer owned;
+		owned | a;
+
+		std::array<std::byte, 256> storage{};
+		external_bit_writer writer(storage);
+		writer | a;
+		EXPECT_EQ(writer.size(), std::size(owned.data()));
+		EXPECT_EQ(std::data(writer.data()), std::data(storage));
+		EXPECT_TRUE(std::ranges::equal(writer.data(), owned.data()));
+		EXPECT_EQ(writer.capacity(), std::size(storage));
+
+		bit_reader reader(std::from_range, writer.data());
+		udt_serialize_from_members<0> b;
+		reader | b;
+		EXPECT_EQ(a, b);
+
+		std::array<std::byte, 8> small{};
+		external_bit_writer throwing(small);
+		throwing | 1;
+		try
+		{
+			throwing | std::string("Foxes");
+			FAIL();
+		}
+		catch (const buffer_overflow& e)
+		{
+			EXPECT_EQ(e.required(), sizeof(int) + sizeof(std::size_t));
+		}
+	}
+
+	TEST(serialize_external_storage, reports_overflow)
+	{
+		const std::vector<int> a(100, 7);
+
+		std::array<std::byte, 64> storage{};
+		external_bit_writer writer(storage, overflow_policy::report);
+		writer | a;
+		EXPECT_TRUE(writer.overflowed());
+		EXPECT_EQ(writer.size(), serialized_size(a));
+		EXPECT_TRUE(std::empty(writer.data()));
+
+		writer.clear();
+		EXPECT_FALSE(writer.overflowed());
+		writer | 5;
+		EXPECT_EQ(std::size(writer.data()), sizeof(int));
+		EXPECT_EQ(std::data(writer.data()), std::data(storage));
+	}
+
+	TEST(serialize_external_storage, spills)
+	{
+		struct chunks
+		{
+			std::vector<std::byte> spilled;
+			std::array<std::byte, 16> storage{};
+			std::size_t calls = 0;
+		} context;
+
+		const auto spill = [](void* ptr, std::span<const std::byte> filled, std::size_t required) -> std::span<std::byte>
+		{
+			auto& c = *static_cast<chunks*>(ptr);
+			c.spilled.insert(std::end(c.spilled), std::begin(filled), std::end(filled));
+			++c.calls;
+			return required <= std::size(c.storage) ? std::span<std::byte>(c.storage) : std::span<std::byte>();
+		};
+
+		const std::vector<std::pair<int, std::int64_t>> a = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+		bit_writer owned;
+		for (const auto& v : a)
+			owned | v;
+
+		external_bit_writer writer(context.storage, +spill, &context);
+		for (const auto& v : a)
+			writer | v;
+
+		context.spilled.insert(std::end(context.spilled), std::begin(writer.data()), std::end(writer.data()));
+		EXPECT_GT(context.calls, 0u);
+		EXPECT_EQ(writer.size(), std::size(owned.data()));
+		EXPECT_TRUE(std::ranges::equal(context.spilled, owned.data()));
+
+		const std::size_t size = writer.size();
+		EXPECT_THROW(writer | std::vector<int>(10), buffer_overflow);
+		EXPECT_EQ(writer.size(), size + sizeof(std::size_t));
+		EXPECT_TRUE(std::empty(writer.data()));
+	}
+
+	TEST(serialize_external_storage, move_only)
+	{
+		std::array<std::byte, 16> storage{};
+		static_assert(!std::is_copy_constructible_v<external_bit_writer>);
+		static_assert(!std::is_copy_assignable_v<external_bit_writer>);
+		static_assert(!std::is_constructible_v<bit_writer, const external_bit_writer&>);
+		static_assert(!std::is_assignable_v<bit_writer&, const external_bit_writer&>);
+		static_assert(std::is_nothrow_move_constructible_v<external_bit_writer>);
+
+		external_bit_writer writer(storage);
+		writer | 1;
+
+		// Copying through a reference to the base bit_writer is still rejected
+		const bit_writer& base = writer;
+		EXPECT_THROW(bit_writer{ base }, std::logic_error);
+
+		external_bit_writer moved(std::move(writer));
+		EXPECT_EQ(std::data(moved.data()), std::data(storage));
+		EXPECT_TRUE(std::empty(writer.data()));
+		writer | 2;
+		EXPECT_NE(std::data(writer.data()), std::data(storage));
+		EXPECT_EQ(moved.size(), sizeof(int));
+	}
+
+	TEST(serialize_size, counting_doesnt_allocate)
+	{
+		const std::vector<int> a(10000, 7);
+		const std::string b(10000, 'f');
+		const std::vector<bool> c(100000, true);
+		const std::deque<std::int64_t> d(10000, 5);
+
+		std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+		bit_writer counting(counting_writer);
+		counting | a | b | c | d;
+		std::pmr::set_default_resource(previous);
+
+		bit_writer owned;
+		owned | a | b | c | d;
+		EXPECT_EQ(counting.size(), std::size(owned.data()));
+	}
+
+	struct large_custom_write
+	{
+		std::array<std::byte, 1000> bytes{};
+
+		void serialize(bit_writer& writer) const
+		{
+			(void)std::memcpy(writer.write_bytes(std::size(bytes)), std::data(bytes), std::size(bytes));
+		}
+	};
+
+	TEST(serialize_size, counting_large_custom_writes)
+	{
+		const std::vector<large_custom_write> a(3);
+
+		std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+		bit_writer counting(counting_writer);
+		counting | a;
+		const std::size_t size = serialized_size(a);
+		std::pmr::set_default_resource(previous);
+
+		EXPECT_EQ(counting.size(), sizeof(std::size_t) + 3 * std::size(a[0].bytes));
+		EXPECT_EQ(size, counting.size());
+		EXPECT_TRUE(std::empty(counting.data()));
+		EXPECT_EQ(counting.capacity(), 0u);
+	}
+
+	TEST(serialize_constant_evaluation, matches_bit_writer)
+	{
+		using table = std::tuple<std::array<std::uint16_t, 4>, std::vector<int>, std::string, std::optional<double>, std::variant<int, std::string>>;
+		const auto make = [] { return table({ 1, 2, 3, 4 }, { 5, 6, 7 }, "Foxes", 1.5, "Capybaras"); };
+
+		constexpr auto blob = serialize_to_array(make);
+
+		bit_writer writer;
+		writer | make();
+		EXPECT_TRUE(std::ranges::equal(blob, writer.data()));
+
+		EXPECT_EQ(deserialize_from_array<table>(blob), make());
+
+		static constexpr auto lookup = serialize_to_array([]
+		{
+			std::array<std::uint32_t, 16> squares{};
+			for (std::uint32_t i = 0; i < 16; ++i)
+				squares[i] = i * i;
+			return squares;
+		});
+		constexpr auto squares = deserialize_from_array<std::array<std::uint32_t, 16>>(lookup);
+		static_assert(squares[15] == 225);
+		static_assert(std::size(lookup) == sizeof(std::size_t) + 16 * sizeof(std::uint32_t));
+
+		bit_reader reader(std::from_range, lookup);
+		EXPECT_EQ(deserialize<std::remove_const_t<decltype(squares)>>(reader), squares);
+	}
+
+	template<std::size_t I>
+	struct variant_alternative_tag {};
+
+	template<std::size_t... Is>
+	std::variant<variant_alternative_tag<Is>...> make_large_variant(std::index_sequence<Is...>);
+
+	TEST(serialize_variant, compact_index)
+	{
+		using large_variant = decltype(make_large_variant(std::make_index_sequence<300>{}));
+		static_assert(std::is_same_v<details::variant_index_t<std::variant<int, std::string>>, std::uint8_t>);
+		static_assert(std::is_same_v<details::variant_index_t<large_variant>, std::uint16_t>);
+
+		const std::vector<std::variant<int, std::string, std::vector<int>>> a = { 1, "Foxes", std::vector<int>{ 1, 2 }, 2 };
+		bit_writer writer;
+		writer | a;
+		EXPECT_EQ(std::size(writer.data()), sizeof(std::size_t) + 4 * sizeof(std::uint8_t) + 2 * sizeof(int) + 2 * sizeof(std::size_t) + 5 + 2 * sizeof(int));
+
+		bit_reader reader(std::from_range, writer.data());
+		std::vector<std::variant<int, std::string, std::vector<int>>> b;
+		reader | b;
+		EXPECT_EQ(a, b);
+
+		bit_reader corrupted(std::from_range, std::array<std::uint8_t, 1>{ 3 });
+		std::variant<int, std::string, std::vector<int>> c;
+		EXPECT_THROW(corrupted | c, std::invalid_argument);
+	}
+
+	struct sparse_config
+	{
+		int id = 0;
+		std::optional<int> width;
+		std::optional<std::string> title;
+		std::optional<double> scale;
+		std::string name;
+
+		[[nodiscard]] bool operator==(const sparse_config&) const = default;
+
+		using serialize_trait = serialize_from_members<sparse_config,
+			&sparse_config::id, &sparse_config::width, &sparse_config::title, &sparse_config::scale, &sparse_config::name>;
+	};
+
+	TEST(serialize_presence_bitmap, serialize_from_members)
+	{
+		sparse_config a;
+		a.id = 1;
+		a.title = "Foxes";
+		a.name = "fox";
+
+		bit_writer writer;
+		writer | a;
+		EXPECT_EQ(std::size(writer.data()), 1 + sizeof(int) + sizeof(std::size_t) + 3 + sizeof(std::size_t) + 5);
+		EXPECT_EQ(std::to_integer<int>(writer.data()[0]), 0b010);
+		EXPECT_EQ(serialized_size(a), std::size(writer.data()));
+
+		bit_reader reader(std::from_range, writer.data());
+		sparse_config b;
+		b.width = 5;
+		b.scale = 2.0;
+		reader | b;
+		EXPECT_EQ(a, b);
+
+		bit_reader corrupted(std::from_range, std::array<std::uint8_t, 1>{ 0b1000 });
+		EXPECT_THROW(corrupted | b, std::invalid_argument);
+
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+		struct sparse_aggregate
+		{
+			std::optional<int> width;
+			std::string name;
+			std::optional<std::vector<int>> values;
+
+			[[nodiscard]] bool operator==(const sparse_aggregate&) const = default;
+		};
+
+		sparse_aggregate c;
+		c.name = "Capybara";
+		c.values = std::vector<int>{ 1, 2 };
+		bit_writer aggregate_writer;
+		aggregate_writer | c;
+		EXPECT_EQ(serialized_size(c), std::size(aggregate_writer.data()));
+
+		bit_reader aggregate_reader(std::from_range, aggregate_writer.data());
+		EXPECT_EQ(deserialize<sparse_aggregate>(aggregate_reader), c);
+
+		async_decoder<sparse_aggregate> decoder;
+		const auto bytes = aggregate_writer.data();
+		for (std::size_t i = 0; i + 1 < std::size(bytes); ++i)
+			ASSERT_EQ(decoder.feed(bytes.subspan(i, 1)), decode_status::need_more);
+		ASSERT_EQ(decoder.feed(bytes.last(1)), decode_status::complete);
+		EXPECT_EQ(decoder.value(), c);
+#endif
+	}
+
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+	struct trivial_sparse_aggregate
+	{
+		int id = 0;
+		std::optional<int> o0, o1, o2, o3, o4, o5, o6;
+		double scale = 0.0;
+		std::optional<double> o7;
+
+		[[nodiscard]] bool operator==(const trivial_sparse_aggregate&) const = default;
+	};
+
+	TEST(serialize_presence_bitmap, trivially_copyable_aggregate)
+	{
+		static_assert(std::is_trivially_copyable_v<trivial_sparse_aggregate>);
+		static_assert(!details::bulk_copyable<trivial_sparse_aggregate>);
+		static_assert(!details::memcpy_compatible_element<trivial_sparse_aggregate>);
+		static_assert(!static_serialized_size_v<trivial_sparse_aggregate>.has_value());
+
+		trivial_sparse_aggregate a;
+		a.id = 7;
+		a.o3 = 3;
+		a.scale = 1.5;
+
+		bit_writer writer;
+		writer | a;
+		EXPECT_EQ(std::size(writer.data()), 1 + sizeof(int) + sizeof(double) + sizeof(int));
+		EXPECT_EQ(std::to_integer<int>(writer.data()[0]), 0b1000);
+		EXPECT_EQ(serialized_size(a), std::size(writer.data()));
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<trivial_sparse_aggregate>(reader), a);
+
+		// Elements of ranges are written with the bitmap as well
+		const std::vector<trivial_sparse_aggregate> b(3, a);
+		bit_writer range_writer;
+		range_writer | b;
+		EXPECT_EQ(std::size(range_writer.data()), sizeof(std::size_t) + 3 * std::size(writer.data()));
+		bit_reader range_reader(std::from_range, range_writer.data());
+		EXPECT_EQ(deserialize<std::vector<trivial_sparse_aggregate>>(range_reader), b);
+
+		static constexpr auto blob = serialize_to_array([]
+		{
+			trivial_sparse_aggregate c;
+			c.o7 = 2.0;
+			return c;
+		});
+		static_assert(std::size(blob) == 1 + sizeof(int) + sizeof(double) + sizeof(double));
+		static_assert(deserialize_from_array<trivial_sparse_aggregate>(blob).o7 == 2.0);
+
+		static_assert(schema_fingerprint_v<trivial_sparse_aggregate> != schema_fingerprint_v<std::tuple<int, std::optional<int>, std::optional<int>,
+			std::optional<int>, std::optional<int>, std::optional<int>, std::optional<int>, std::optional<int>, double, std::optional<double>>>);
+
+		async_decoder<trivial_sparse_aggregate> decoder;
+		ASSERT_EQ(decoder.feed(writer.data()), decode_status::complete);
+		EXPECT_EQ(decoder.value(), a);
+	}
+#endif
+
+	template<std::size_t... Is>
+	details::presence_members<std::conditional_t<Is == 0, int, std::optional<int>>...> make_presence_members(std::index_sequence<Is...>);
+
+	TEST(serialize_presence_bitmap, many_optionals)
+	{
+		using members = decltype(make_presence_members(std::make_index_sequence<71>{}));
+		static_assert(members::optional_count == 70);
+		static_assert(members::bitmap_size == 9);
+
+		int id = 7;
+		std::array<std::optional<int>, 70> a;
+		a[0] = 1;
+		a[63] = 2;
+		a[64] = 3;
+		a[69] = 4;
+
+		const auto getter = [&](auto& id_ref, auto& optionals)
+		{
+			return [&]<std::size_t I>(std::integral_constant<std::size_t, I>) -> decltype(auto)
+			{
+				if constexpr (I == 0)
+					return (id_ref);
+				else
+					return (optionals[I - 1]);
+			};
+		};
+
+		bit_writer writer;
+		members::serialize(writer, getter(id, a));
+		EXPECT_EQ(std::size(writer.data()), members::bitmap_size + sizeof(int) + 4 * sizeof(int));
+
+		int id_out = 0;
+		std::array<std::optional<int>, 70> b;
+		b.fill(9);
+		bit_reader reader(std::from_range, writer.data());
+		members::deserialize(reader, getter(id_out, b));
+		EXPECT_EQ(id_out, id);
+		EXPECT_EQ(a, b);
+	}
+
+	struct fingerprinted_type
+	{
+		static constexpr std::uint64_t schema_fingerprint = 42;
+
+		int v = 0;
+
+		void serialize(bit_writer& writer) const
+		{
+			writer | v;
+		}
+
+		void deserialize(bit_reader& reader)
+		{
+			reader | v;
+		}
+	};
+
+	template<class T0, class T1, std::size_t I = 0>
+	class fingerprinted_members
+	{
+		T0 v0_{};
+		T1 v1_{};
+
+	public:
+		using serialize_trait = serialize_from_members<fingerprinted_members, &fingerprinted_members::v0_, &fingerprinted_members::v1_>;
+	};
+
+	struct fingerprinted_aggregate
+	{
+		std::string name;
+		int id = 0;
+	};
+
+	TEST(serialize_schema_fingerprint, layout)
+	{
+		static_assert(schema_fingerprint_v<std::vector<int>> == schema_fingerprint_v<std::list<int>>);
+		static_assert(schema_fingerprint_v<std::string> == schema_fingerprint_v<std::vector<char>>);
+		static_assert(schema_fingerprint_v<const int&> == schema_fingerprint_v<int>);
+		static_assert(schema_fingerprint_v<std::vector<int>> != schema_fingerprint_v<std::vector<unsigned int>>);
+		static_assert(schema_fingerprint_v<std::vector<int>> != schema_fingerprint_v<std::vector<std::int64_t>>);
+		static_assert(schema_fingerprint_v<std::tuple<int, float>> != schema_fingerprint_v<std::tuple<float, int>>);
+		static_assert(schema_fingerprint_v<std::variant<int, float>> != schema_fingerprint_v<std::variant<float, int>>);
+		static_assert(schema_fingerprint_v<std::array<int, 3>> != schema_fingerprint_v<std::array<int, 4>>);
+		static_assert(schema_fingerprint_v<std::optional<int>> != schema_fingerprint_v<int>);
+		static_assert(schema_fingerprint_v<fingerprinted_type> != schema_fingerprint_v<udt_serialize_from_members<0>>);
+		static_assert(schema_fingerprint_v<std::shared_ptr<shared_node>> != schema_fingerprint_v<std::unique_ptr<shared_node>>);
+
+		static_assert(schema_fingerprint_v<fingerprinted_members<std::string, int>> != schema_fingerprint_v<fingerprinted_members<int, std::string>>);
+		static_assert(schema_fingerprint_v<fingerprinted_members<std::string, int>> != schema_fingerprint_v<fingerprinted_members<std::string, std::int64_t>>);
+		static_assert(schema_fingerprint_v<fingerprinted_members<std::string, int>> == schema_fingerprint_v<fingerprinted_members<std::string, int, 1>>);
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+		static_assert(schema_fingerprint_v<fingerprinted_members<std::string, int>> == schema_fingerprint_v<fingerprinted_aggregate>);
+#endif
+	}
+
+	TEST(serialize_schema_fingerprint, verify)
+	{
+		using message = std::vector<std::pair<int, std::string>>;
+		const message a = { { 1, "Fox" }, { 2, "Capybara" } };
+
+		bit_writer writer;
+		write_schema_fingerprint<message>(writer);
+		writer | a;
+
+		bit_reader reader(std::from_range, writer.data());
+		verify_schema_fingerprint<message>(reader);
+		EXPECT_EQ(deserialize<message>(reader), a);
+
+		bit_reader mismatched(std::from_range, writer.data());
+		try
+		{
+			verify_schema_fingerprint<std::vector<std::pair<int, std::vector<int>>>>(mismatched);
+			FAIL();
+		}
+		catch (const schema_mismatch& e)
+		{
+			EXPECT_EQ(e.actual(), schema_fingerprint_v<message>);
+		}
+	}
+
+	TEST(serialize_packed_bits, vector_bool)
+	{
+		for (const std::size_t size : { 0, 1, 63, 64, 65, 200 })
+		{
+			std::vector<bool> a(size);
+			for (std::size_t i = 0; i < size; ++i)
+				a[i] = (i * 7) % 3 == 0;
+
+			bit_writer writer;
+			writer | a;
+			EXPECT_EQ(std::size(writer.data()), sizeof(std::size_t) + sizeof(std::uint64_t) * ((size + 63) / 64));
+			EXPECT_EQ(serialized_size(a), std::size(writer.data()));
+
+			bit_reader reader(std::from_range, writer.data());
+			EXPECT_EQ(deserialize<std::vector<bool>>(reader), a);
+		}
+
+		// Words are read into the existing vector, bits past the new size don't leak
+		std::vector<bool> reused(300, true);
+		const std::vector<bool> a = { true, false, true };
+		bit_writer writer;
+		writer | a;
+		bit_reader reader(std::from_range, writer.data());
+		reader | reused;
+		EXPECT_EQ(reused, a);
+
+		constexpr auto blob = serialize_to_array([] { return std::vector<bool>{ true, false, false, true, true }; });
+		bit_writer constant_writer;
+		constant_writer | std::vector<bool>{ true, false, false, true, true };
+		EXPECT_TRUE(std::ranges::equal(blob, constant_writer.data()));
+	}
+
+	TEST(serialize_packed_bits, async)
+	{
+		using message = std::tuple<std::vector<bool>, std::bitset<100>>;
+		const message a(std::vector<bool>(130, true), std::bitset<100>().set(99));
+
+		bit_writer writer;
+		writer | a;
+		const auto bytes = writer.data();
+
+		async_decoder<message> decoder;
+		for (std::size_t i = 0; i + 1 < std::size(bytes); ++i)
+			ASSERT_EQ(decoder.feed(bytes.subspan(i, 1)), decode_status::need_more);
+
+		ASSERT_EQ(decoder.feed(bytes.last(1)), decode_status::complete);
+		EXPECT_EQ(decoder.value(), a);
+	}
+
+	TEST(serialize_packed_bits, bitset)
+	{
+		std::bitset<10> small(0b1011001101);
+		std::bitset<64> word(0xF0F0F0F0'12345678ull);
+		std::bitset<200> large;
+		for (std::size_t i = 0; i < large.size(); i += 3)
+			large.set(i);
+
+		static_assert(static_serialized_size_v<std::bitset<10>> == sizeof(std::uint64_t));
+		static_assert(static_serialized_size_v<std::bitset<200>> == 4 * sizeof(std::uint64_t));
+		static_assert(schema_fingerprint_v<std::bitset<10>> != schema_fingerprint_v<std::bitset<11>>);
+
+		bit_writer writer;
+		writer | small | word | large;
+		EXPECT_EQ(std::size(writer.data()), 6 * sizeof(std::uint64_t));
+
+		std::uint64_t first_word{};
+		std::memcpy(&first_word, std::data(writer.data()), sizeof(first_word));
+		EXPECT_EQ(first_word, small.to_ullong());
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<std::bitset<10>>(reader), small);
+		EXPECT_EQ(deserialize<std::bitset<64>>(reader), word);
+		EXPECT_EQ(deserialize<std::bitset<200>>(reader), large);
+
+		// Ranges of bitsets are packed too
+		const std::vector<std::bitset<200>> masks = { large, ~large };
+		bit_writer range_writer;
+		range_writer | masks;
+		EXPECT_EQ(std::size(range_writer.data()), sizeof(std::size_t) + 2 * 4 * sizeof(std::uint64_t));
+		bit_reader range_reader(std::from_range, range_writer.data());
+		EXPECT_EQ(deserialize<std::vector<std::bitset<200>>>(range_reader), masks);
+	}
+
+	TEST(serialize_packed_bits, large_bitset)
+	{
+		constexpr std::size_t size = std::size_t(1) << 20;
+		auto a = std::make_unique<std::bitset<size>>();
+		for (std::size_t i = 0; i < size; i += 7)
+			a->set(i);
+		a->set(size - 1);
+
+		bit_writer writer;
+		writer | *a;
+		ASSERT_EQ(std::size(writer.data()), size / 8);
+
+		std::uint64_t word;
+		(void)std::memcpy(&word, std::data(writer.data()) + sizeof(std::uint64_t), sizeof(std::uint64_t));
+		EXPECT_EQ(word & 1, 0u);
+		EXPECT_EQ((word >> 6) & 1, 1u);
+
+		bit_reader reader(std::from_range, writer.data());
+		auto b = std::make_unique<std::bitset<size>>();
+		b->set(1);
+		reader | *b;
+		EXPECT_EQ(*a, *b);
+	}
+
+	TEST(serialize_segmented_ranges, deque)
+	{
+		std::deque<double> a;
+		for (int i = 0; i < 1000; ++i)
+			a.push_back(i * 0.5);
+		for (int i = 0; i < 100; ++i)
+			a.push_front(-i * 0.5);
+
+		// Blocks are found through element addresses, they cover the elements in order
+		static_assert(details::segmented_range<const std::deque<double>>);
+		std::size_t segments = 0;
+		std::size_t covered = 0;
+		details::for_each_segment(a, [&](const double* segment, std::size_t count)
+		{
+			EXPECT_EQ(segment, std::addressof(a[covered]));
+			++segments;
+			covered += count;
+		});
+		EXPECT_EQ(covered, std::size(a));
+		EXPECT_LT(segments, std::size(a) / 8);
+
+		bit_writer writer;
+		writer | a;
+
+		bit_writer vector_writer;
+		vector_writer | std::vector<double>(a.begin(), a.end());
+		EXPECT_TRUE(std::ranges::equal(writer.data(), vector_writer.data()));
+
+		std::deque<double> b(5000, 1.0);
+		bit_reader reader(std::from_range, writer.data());
+		reader | b;
+		EXPECT_EQ(a, b);
+	}
+
+	// Fixed capacity ring buffer exposing its storage as two segments
+	class ring_buffer
+	{
+		std::array<int, 8> storage_{};
+		std::size_t head_ = 0;
+		std::size_t size_ = 0;
+
+	public:
+		struct iterator
+		{
+			using value_type = int;
+			using difference_type = std::ptrdiff_t;
+
+			const ring_buffer* ring = nullptr;
+			std::size_t index = 0;
+
+			const int& operator*() const
+			{
+				return ring->storage_[(ring->head_ + index) % std::size(ring->storage_)];
+			}
+
+			iterator& operator++()
+			{
+				++index;
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				auto copy = *this;
+				++index;
+				return copy;
+			}
+
+			bool operator==(const iterator&) const = default;
+		};
+
+		[[nodiscard]] iterator begin() const
+		{
+			return { this, 0 };
+		}
+
+		[[nodiscard]] iterator end() const
+		{
+			return { this, size_ };
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return size_;
+		}
+
+		void push_back(int v)
+		{
+			storage_[(head_ + size_++) % std::size(storage_)] = v;
+		}
+
+		void pop_front()
+		{
+			head_ = (head_ + 1) % std::size(storage_);
+			--size_;
+		}
+
+		void resize(std::size_t size)
+		{
+			if (size > std::size(storage_))
+				throw std::length_error("Ring buffer overflow.");
+			size_ = size;
+		}
+
+		[[nodiscard]] std::array<std::span<const int>, 2> segments() const
+		{
+			const std::size_t first = std::min(size_, std::size(storage_) - head_);
+			return { std::span(storage_).subspan(head_, first), std::span(storage_).first(size_ - first) };
+		}
+
+		[[nodiscard]] std::array<std::span<int>, 2> segments()
+		{
+			const std::size_t first = std::min(size_, std::size(storage_) - head_);
+			return { std::span(storage_).subspan(head_, first), std::span(storage_).first(size_ - first) };
+		}
+	};
+
+	TEST(serialize_segmented_ranges, custom_segments)
+	{
+		static_assert(details::segmented_range<const ring_buffer>);
+
+		ring_buffer a;
+		for (int i = 0; i < 6; ++i)
+			a.push_back(i);
+		for (int i = 0; i < 5; ++i)
+			a.pop_front();
+		for (int i = 6; i < 12; ++i)
+			a.push_back(i);
+
+		bit_writer writer;
+		writer | a;
+
+		bit_writer vector_writer;
+		vector_writer | std::vector<int>(a.begin(), a.end());
+		EXPECT_TRUE(std::ranges::equal(writer.data(), vector_writer.data()));
+
+		ring_buffer b;
+		b.push_back(100);
+		b.pop_front();
+		bit_reader reader(std::from_range, writer.data());
+		reader | b;
+		EXPECT_TRUE(std::ranges::equal(a, b));
+	}
+
+	TEST(serialize_single_pass_ranges, forward_list)
+	{
+		const std::forward_list<std::string> a = { "Fox", "Capybara", "Axolotl" };
+
+		bit_writer writer;
+		writer | a;
+		EXPECT_EQ(serialized_size(a), std::size(writer.data()));
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<std::vector<std::string>>(reader), std::vector<std::string>(a.begin(), a.end()));
+	}
+
+	TEST(serialize_single_pass_ranges, views)
+	{
+		std::vector<int> values(100);
+		std::iota(values.begin(), values.end(), 0);
+
+		// filter_view can only be iterated when non-const and has no size
+		bit_writer writer;
+		serialize_range(writer, values | std::views::filter([](int v) { return v % 3 == 0; }));
+		serialize_range(writer, values | std::views::transform([](int v) { return v * 0.5f; }));
+
+		bit_reader reader(std::from_range, writer.data());
+		const auto multiples = deserialize<std::vector<int>>(reader);
+		ASSERT_EQ(std::size(multiples), 34u);
+		EXPECT_EQ(multiples.back(), 99);
+		const auto halves = deserialize<std::vector<float>>(reader);
+		ASSERT_EQ(std::size(halves), 100u);
+		EXPECT_EQ(halves[3], 1.5f);
+	}
+
+	template<class Range>
+	concept single_pass_serializable = requires(bit_writer& writer, Range&& range) { serialize_range(writer, std::forward<Range>(range)); };
+
+	TEST(serialize_single_pass_ranges, memcpy_compatible_elements)
+	{
+		static_assert(single_pass_serializable<std::vector<int>&>);
+		static_assert(!single_pass_serializable<std::vector<bool>&>);
+
+		const std::vector<std::optional<int>> a = { 1, std::nullopt, 3 };
+		bit_writer expected;
+		expected | a;
+
+		bit_writer contiguous;
+		serialize_range(contiguous, a);
+		EXPECT_TRUE(std::ranges::equal(contiguous.data(), expected.data()));
+
+		bit_writer sized;
+		serialize_range(sized, std::list<std::optional<int>>(a.begin(), a.end()));
+		EXPECT_TRUE(std::ranges::equal(sized.data(), expected.data()));
+
+		bit_writer unsized;
+		serialize_range(unsized, a | std::views::filter([](const std::optional<int>&) { return true; }));
+		EXPECT_TRUE(std::ranges::equal(unsized.data(), expected.data()));
+
+		const std::forward_list<std::optional<int>> b(a.begin(), a.end());
+		const std::deque<std::optional<int>> c(a.begin(), a.end());
+		bit_writer writer;
+		writer | b | c;
+		EXPECT_EQ(serialized_size(b, c), std::size(writer.data()));
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<std::forward_list<std::optional<int>>>(reader), b);
+		EXPECT_EQ(deserialize<std::deque<std::optional<int>>>(reader), c);
+	}
+
+	TEST(serialize_single_pass_ranges, patch)
+	{
+		bit_writer writer;
+		writer | 'a';
+		const std::size_t position = writer.write_placeholder(sizeof(std::uint32_t));
+		writer | 'b';
+		writer.patch(position, static_cast<std::uint32_t>(42));
+		EXPECT_THROW(writer.patch(std::size(writer.data()), 'c'), std::out_of_range);
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<char>(reader), 'a');
+		EXPECT_EQ(deserialize<std::uint32_t>(reader), 42u);
+		EXPECT_EQ(deserialize<char>(reader), 'b');
+
+		// Spilled bytes can't be patched anymore
+		std::array<std::byte, 8> first{};
+		std::array<std::byte, 64> second{};
+		external_bit_writer spilling(first, [](void* context, std::span<const std::byte>, std::size_t) -> std::span<std::byte>
+		{
+			return *static_cast<std::array<std::byte, 64>*>(context);
+		}, &second);
+
+		const std::size_t spilled = spilling.write_placeholder(sizeof(std::size_t));
+		spilling | 1;
+		const std::size_t kept = spilling.write_placeholder(sizeof(std::size_t));
+		EXPECT_THROW(spilling.patch(spilled, std::size_t{ 1 }), std::out_of_range);
+		spilling.patch(kept, std::size_t{ 2 });
+
+		std::size_t value{};
+		std::memcpy(&value, std::data(second) + sizeof(int), sizeof(value));
+		EXPECT_EQ(value, 2u);
+	}
+
+	TEST(serialize_md_array, bulk)
+	{
+		md_array<float, 3> a(2, 3, 4);
+		for (std::size_t i = 0; i < 2; ++i)
+			for (std::size_t j = 0; j < 3; ++j)
+				for (std::size_t k = 0; k < 4; ++k)
+					a[i, j, k] = static_cast<float>(i * 100 + j * 10 + k);
+
+		EXPECT_EQ(a.flat()[1 * 12 + 2 * 4 + 3], 123.f);
+
+		bit_writer writer;
+		writer | a;
+		EXPECT_EQ(std::size(writer.data()), 3 * sizeof(std::size_t) + 24 * sizeof(float));
+		EXPECT_EQ(serialized_size(a), std::size(writer.data()));
+
+		bit_reader reader(std::from_range, writer.data());
+		const auto b = deserialize<md_array<float, 3>>(reader);
+		EXPECT_EQ(a, b);
+		EXPECT_EQ(b.extent(1), 3u);
+
+		static_assert(schema_fingerprint_v<md_array<float, 2>> != schema_fingerprint_v<md_array<float, 3>>);
+		static_assert(schema_fingerprint_v<md_array<float, 2>> != schema_fingerprint_v<std::vector<std::vector<float>>>);
+	}
+
+	TEST(serialize_md_array, elements)
+	{
+		md_array<std::string, 2> a(2, 2);
+		a[0, 1] = "Fox";
+		a[1, 0] = "Capybara";
+
+		bit_writer writer;
+		writer | a;
+
+		md_array<std::string, 2> b({ 5, 5 }, "Axolotl");
+		bit_reader reader(std::from_range, writer.data());
+		reader | b;
+		EXPECT_EQ(a, b);
+
+		// Corrupted extents
+		bit_writer corrupted;
+		corrupted | std::numeric_limits<std::size_t>::max() | std::numeric_limits<std::size_t>::max();
+		bit_reader corrupted_reader(std::from_range, corrupted.data());
+		EXPECT_THROW(corrupted_reader | b, std::length_error);
+	}
+
+#if defined(__cpp_lib_mdspan)
+	TEST(serialize_md_array, mdspan)
+	{
+		std::array<int, 6> storage = { 0, 1, 2, 3, 4, 5 };
+
+		// Row-major is copied as is, column-major is gathered into the row-major order
+		const std::mdspan<const int, std::dextents<std::size_t, 2>> right(std::data(storage), 2, 3);
+		const std::mdspan<const int, std::dextents<std::size_t, 2>, std::layout_left> left(std::data(storage), 2, 3);
+
+		bit_writer writer;
+		writer | right | left;
+
+		bit_reader reader(std::from_range, writer.data());
+		const auto a = deserialize<md_array<int, 2>>(reader);
+		const auto b = deserialize<md_array<int, 2>>(reader);
+		EXPECT_EQ((a[1, 0]), 3);
+		EXPECT_EQ((b[1, 0]), 1);
+		EXPECT_EQ((b[0, 1]), 2);
+
+		// Read into a view with matching extents
+		bit_writer left_writer;
+		left_writer | left;
+
+		std::array<int, 6> target{};
+		std::mdspan<int, std::dextents<std::size_t, 2>, std::layout_left> view(std::data(target), 2, 3);
+		bit_reader view_reader(std::from_range, left_writer.data());
+		view_reader | view;
+		EXPECT_EQ(target, storage);
+
+		std::mdspan<int, std::dextents<std::size_t, 2>> mismatched(std::data(target), 3, 2);
+		bit_reader mismatched_reader(std::from_range, left_writer.data());
+		EXPECT_THROW(mismatched_reader | mismatched, std::out_of_range);
+
+		// Gathered elements are written as object bytes, as md_array reads them
+		std::array<std::optional<int>, 6> optionals = { 0, std::nullopt, 2, 3, std::nullopt, 5 };
+		const std::mdspan<const std::optional<int>, std::dextents<std::size_t, 2>, std::layout_left> optional_view(std::data(optionals), 2, 3);
+		bit_writer optional_writer;
+		optional_writer | optional_view;
+
+		bit_reader optional_reader(std::from_range, optional_writer.data());
+		const auto c = deserialize<md_array<std::optional<int>, 2>>(optional_reader);
+		EXPECT_EQ((c[0, 1]), std::optional<int>(2));
+		EXPECT_EQ((c[1, 0]), std::nullopt);
+
+		std::array<std::optional<int>, 6> optional_target{};
+		std::mdspan<std::optional<int>, std::dextents<std::size_t, 2>, std::layout_left> optional_target_view(std::data(optional_target), 2, 3);
+		bit_reader optional_view_reader(std::from_range, optional_writer.data());
+		optional_view_reader | optional_target_view;
+		EXPECT_EQ(optional_target, optionals);
+	}
+#endif
+
+	TEST(serialize_decode_limits, forged_length)
+	{
+		// Length prefix claims far more elements than the data holds, it's rejected before allocating them
+		bit_writer writer;
+		writer | (std::numeric_limits<std::size_t>::max() / 2) | std::string("Fox");
+
+		bit_reader reader(std::from_range, writer.data());
+		std::vector<std::string> strings;
+		EXPECT_THROW(reader | strings, end_of_buffer);
+		EXPECT_TRUE(strings.empty());
+
+		bit_reader nested_reader(std::from_range, writer.data());
+		EXPECT_THROW((void)deserialize<std::vector<std::vector<int>>>(nested_reader), end_of_buffer);
+	}
+
+	TEST(serialize_decode_limits, elements_and_bytes)
+	{
+		const std::vector<std::int32_t> a(100, 7);
+		bit_writer writer;
+		writer | a | a;
+
+		bit_reader reader(std::from_range, writer.data());
+		reader.set_limits({ .max_elements = 10 });
+		try
+		{
+			(void)deserialize<std::vector<std::int32_t>>(reader);
+			FAIL();
+		}
+		catch (const decode_limit_exceeded& e)
+		{
+			EXPECT_EQ(e.limit(), decode_limit::elements);
+		}
+
+		bit_reader budget_reader(std::from_range, writer.data());
+		budget_reader.set_limits({ .max_allocated_bytes = 600 });
+		EXPECT_EQ(deserialize<std::vector<std::int32_t>>(budget_reader), a);
+		EXPECT_EQ(budget_reader.allocated(), 400u);
+		try
+		{
+			(void)deserialize<std::vector<std::int32_t>>(budget_reader);
+			FAIL();
+		}
+		catch (const decode_limit_exceeded& e)
+		{
+			EXPECT_EQ(e.limit(), decode_limit::allocated_bytes);
+		}
+
+		// Budget is reset with the data
+		budget_reader.assign(writer.data());
+		EXPECT_EQ(budget_reader.allocated(), 0u);
+		EXPECT_EQ(deserialize<std::vector<std::int32_t>>(budget_reader), a);
+	}
+
+	TEST(serialize_decode_limits, depth)
+	{
+		std::vector<std::vector<std::vector<int>>> nested = { { { 1, 2 }, { 3 } } };
+		bit_writer writer;
+		writer | nested;
+
+		bit_reader reader(std::from_range, writer.data());
+		reader.set_limits({ .max_depth = 2 });
+		EXPECT_THROW(reader | nested, decode_limit_exceeded);
+
+		bit_reader deep_enough(std::from_range, writer.data());
+		deep_enough.set_limits({ .max_depth = 3 });
+		EXPECT_NO_THROW(deep_enough | nested);
+
+		// Deeply linked pointees
+		using inner = std::pair<int, std::unique_ptr<int>>;
+		using outer = std::pair<int, std::unique_ptr<inner>>;
+		auto chain = std::make_unique<outer>(1, std::make_unique<inner>(2, std::make_unique<int>(3)));
+		bit_writer chain_writer;
+		chain_writer | chain;
+
+		bit_reader chain_reader(std::from_range, chain_writer.data());
+		chain_reader.set_limits({ .max_depth = 2 });
+		EXPECT_THROW(chain_reader | chain, decode_limit_exceeded);
+	}
+
+	TEST(serialize_decode_limits, async)
+	{
+		bit_writer writer;
+		writer | std::vector<std::string>(20, "Fox");
+
+		async_decoder<std::vector<std::string>> decoder;
+		decoder.set_limits({ .max_elements = 10 });
+		EXPECT_THROW((void)decoder.feed(writer.data()), decode_limit_exceeded);
+	}
+
+	TEST(serialize_decode_limits, async_chunked)
+	{
+		using message = std::vector<std::pair<std::optional<int>, std::vector<std::string>>>;
+		message a;
+		for (int i = 0; i < 20; ++i)
+			a.emplace_back(i % 3 == 0 ? std::nullopt : std::optional<int>(i), std::vector<std::string>(3, std::string(40, 'a' + static_cast<char>(i))));
+
+		bit_writer writer;
+		writer | a;
+
+		bit_reader reader(std::from_range, writer.data());
+		(void)deserialize<message>(reader);
+		const std::size_t allocated = reader.allocated();
+
+		// Elements split between chunks are retried, bytes charged by the failed attempts are given back
+		for (const std::size_t chunk : { 7, 64, 100 })
+		{
+			async_decoder<message> decoder;
+			decoder.set_limits({ .max_allocated_bytes = allocated });
+			for (std::size_t i = 0; i < std::size(writer.data()); i += chunk)
+				(void)decoder.feed(writer.data().subspan(i, std::min(chunk, std::size(writer.data()) - i)));
+
+			ASSERT_TRUE(decoder.done());
+			EXPECT_EQ(decoder.value(), a);
+		}
+	}
+
+	TEST(serialize_aligned_layout, natural_alignment)
+	{
+		const std::vector<double> a = { 1.0, 2.0, 3.0 };
+
+		bit_writer writer;
+		writer.set_alignment(1);
+		writer | 'x' | a | std::list<double>(a.begin(), a.end());
+
+		// Length prefix at 1, elements padded to 16
+		EXPECT_EQ(std::size(writer.data()), 16 + 3 * sizeof(double) + sizeof(std::size_t) + 3 * sizeof(double));
+
+		aligned_memory_resource resource(alignof(double));
+		bit_reader reader(&resource);
+		reader.set_alignment(1);
+		reader.assign(writer.data());
+
+		EXPECT_EQ(deserialize<char>(reader), 'x');
+		const std::span<const double> view = read_span<double>(reader);
+		EXPECT_TRUE(std::ranges::equal(view, a));
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(std::data(view)) % alignof(double), 0u);
+		EXPECT_EQ(deserialize<std::vector<double>>(reader), a);
+
+		EXPECT_THROW(writer.set_alignment(3), std::invalid_argument);
+	}
+
+	TEST(serialize_aligned_layout, simd_alignment)
+	{
+		std::vector<float> a(37);
+		std::iota(a.begin(), a.end(), 0.f);
+		md_array<float, 2> image(3, 5);
+
+		bit_writer writer;
+		writer.set_alignment(64);
+		writer | std::uint8_t{ 1 } | a | image;
+
+		aligned_memory_resource resource(64);
+		bit_reader reader(&resource);
+		reader.set_alignment(64);
+		reader.assign(writer.data());
+
+		EXPECT_EQ(deserialize<std::uint8_t>(reader), 1);
+		const std::span<const float> view = read_span<float>(reader);
+		EXPECT_TRUE(std::ranges::equal(view, a));
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(std::data(view)) % 64, 0u);
+		EXPECT_EQ((deserialize<md_array<float, 2>>(reader)), image);
+
+		// Alignment is kept when consumed data is discarded
+		bit_reader discarding(&resource);
+		discarding.set_alignment(64);
+		discarding.assign(writer.data());
+		(void)deserialize<std::uint8_t>(discarding);
+		discarding.discard_consumed();
+		EXPECT_EQ(deserialize<std::vector<float>>(discarding), a);
+
+		async_decoder<std::tuple<std::uint8_t, std::vector<float>, md_array<float, 2>>> decoder;
+		decoder.set_alignment(64);
+		for (const std::byte b : writer.data())
+			(void)decoder.feed({ &b, 1 });
+		ASSERT_TRUE(decoder.done());
+		EXPECT_EQ(std::get<1>(decoder.value()), a);
+		EXPECT_EQ(std::get<2>(decoder.value()), image);
+	}
+
+	TEST(serialize_aligned_layout, misaligned)
+	{
+		bit_writer writer;
+		writer | 'x' | std::vector<double>{ 1.0 };
+
+		bit_reader reader(std::from_range, writer.data());
+		(void)deserialize<char>(reader);
+		EXPECT_THROW((void)read_span<double>(reader), std::invalid_argument);
+	}
+
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+	struct flat_position
+	{
+		float x;
+		float y;
+
+		[[nodiscard]] bool operator==(const flat_position&) const = default;
+	};
+
+	struct flat_owner
+	{
+		std::string name;
+		std::uint16_t age;
+
+		[[nodiscard]] bool operator==(const flat_owner&) const = default;
+	};
+
+	struct flat_record
+	{
+		std::uint32_t id;
+		std::string name;
+		flat_position position;
+		std::vector<double> samples;
+		flat_owner owner;
+		bool active;
+
+		[[nodiscard]] bool operator==(const flat_record&) const = default;
+	};
+
+	TEST(serialize_flat_layout, access_without_parsing)
+	{
+		static_assert(flat_serializable<flat_record>);
+		static_assert(!flat_serializable<std::tuple<int>>);
+
+		const flat_record a{ 7, "Axolotl", { 1.f, 2.f }, { 0.5, 1.5, 2.5 }, { "Capybara", 42 }, true };
+
+		bit_writer writer;
+		writer | std::uint8_t{ 3 };
+		serialize_flat(writer, a);
+
+		// Views point directly into the buffer, which doesn't have to be aligned
+		const flat_view<flat_record> view(writer.data().subspan(1));
+		static_assert(flat_view<flat_record>::size() == 6);
+		EXPECT_EQ(view.get<0>(), 7u);
+		EXPECT_EQ(view.get<1>(), "Axolotl");
+		EXPECT_GE(view.get<1>().data(), reinterpret_cast<const char*>(std::data(writer.data())));
+		EXPECT_EQ(view.get<2>(), (flat_position{ 1.f, 2.f }));
+
+		const flat_array<double> samples = view.get<3>();
+		ASSERT_EQ(std::size(samples), 3u);
+		EXPECT_EQ(samples[1], 1.5);
+		EXPECT_EQ(samples.to(), a.samples);
+		EXPECT_THROW((void)samples.at(3), std::out_of_range);
+
+		const flat_view<flat_owner> owner = view.get<4>();
+		EXPECT_EQ(owner.get<0>(), "Capybara");
+		EXPECT_EQ(owner.get<1>(), 42);
+		EXPECT_TRUE(view.get<5>());
+		EXPECT_EQ(view.to(), a);
+
+		bit_writer counting(counting_writer);
+		serialize_flat(counting, a);
+		EXPECT_EQ(counting.size(), std::size(writer.data()) - 1);
+	}
+
+	TEST(serialize_flat_layout, corrupted)
+	{
+		const flat_record a{ 1, "Quokka", {}, { 1.0 }, { "Wombat", 3 }, false };
+
+		bit_writer writer;
+		serialize_flat(writer, a);
+		const auto bytes = writer.data();
+
+		EXPECT_THROW(flat_view<flat_record>(bytes.first(3)), end_of_buffer);
+
+		// Truncated variable length data
+		const flat_view<flat_record> truncated(bytes.first(std::size(bytes) - 4));
+		EXPECT_EQ(truncated.get<0>(), 1u);
+		EXPECT_EQ(truncated.get<1>(), "Quokka");
+		EXPECT_THROW((void)truncated.get<4>().get<0>(), end_of_buffer);
+
+		// Offsets pointing into the inline section or past the data
+		std::vector<std::byte> forged(std::begin(bytes), std::end(bytes));
+		const std::size_t name_slot = sizeof(std::uint32_t);
+		for (const std::size_t offset : { std::size_t{ 0 }, std::size(forged) + 1 })
+		{
+			(void)std::memcpy(std::data(forged) + name_slot, &offset, sizeof(offset));
+			EXPECT_THROW((void)flat_view<flat_record>(forged).get<1>(), std::out_of_range);
+		}
+	}
+#endif
+
+	enum class compact_color : int
+	{
+		red = 3,
+		green,
+		blue,
+		alpha
+	};
+
+	template<>
+	struct enum_range<compact_color>
+	{
+		static constexpr compact_color min = compact_color::red;
+		static constexpr compact_color max = compact_color::alpha;
+	};
+
+	enum class compact_delta : std::int32_t
+	{
+		lowest = -1000,
+		highest = 1000
+	};
+
+	template<>
+	struct enum_range<compact_delta>
+	{
+		static constexpr compact_delta min = compact_delta::lowest;
+		static constexpr compact_delta max = compact_delta::highest;
+	};
+
+	enum class wide_color : int
+	{
+		red = 3
+	};
+
+	TEST(serialize_enum_range, compact)
+	{
+		static_assert(static_serialized_size_v<compact_color> == sizeof(std::uint8_t));
+		static_assert(static_serialized_size_v<compact_delta> == sizeof(std::uint16_t));
+		static_assert(static_serialized_size_v<wide_color> == sizeof(int));
+		static_assert(schema_fingerprint_v<compact_color> != schema_fingerprint_v<wide_color>);
+
+		const std::vector<compact_color> a{ compact_color::red, compact_color::alpha, compact_color::green };
+		bit_writer writer;
+		writer | a | compact_delta::lowest | static_cast<compact_delta>(-3);
+		EXPECT_EQ(std::size(writer.data()), sizeof(std::size_t) + 3 + 2 + 2);
+		EXPECT_EQ(serialized_size(a), sizeof(std::size_t) + 3);
+		EXPECT_EQ(std::to_integer<int>(writer.data()[sizeof(std::size_t) + 1]), 3);
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<std::vector<compact_color>>(reader), a);
+		EXPECT_EQ(deserialize<compact_delta>(reader), compact_delta::lowest);
+		EXPECT_EQ(deserialize<compact_delta>(reader), static_cast<compact_delta>(-3));
+
+		constexpr auto blob = serialize_to_array([] { return std::pair{ compact_color::blue, compact_delta::highest }; });
+		static_assert(std::size(blob) == 3);
+		EXPECT_EQ((deserialize_from_array<std::pair<compact_color, compact_delta>>(blob)), (std::pair{ compact_color::blue, compact_delta::highest }));
+
+		async_decoder<std::vector<compact_color>> decoder;
+		for (const std::byte b : writer.data().first(sizeof(std::size_t) + 3))
+			(void)decoder.feed({ &b, 1 });
+		ASSERT_TRUE(decoder.done());
+		EXPECT_EQ(decoder.value(), a);
+	}
+
+	TEST(serialize_enum_range, out_of_range)
+	{
+		bit_writer writer;
+		EXPECT_THROW(writer | static_cast<compact_color>(7), std::out_of_range);
+		EXPECT_THROW(writer | static_cast<compact_color>(2), std::out_of_range);
+		EXPECT_THROW(writer | static_cast<compact_delta>(1001), std::out_of_range);
+
+		for (const std::uint8_t offset : { 4, 255 })
+		{
+			bit_reader reader(std::from_range, std::array<std::uint8_t, 1>{ offset });
+			EXPECT_THROW((void)deserialize<compact_color>(reader), std::out_of_range);
+		}
+
+		bit_reader reader(std::from_range, std::array<std::uint16_t, 1>{ 2001 });
+		EXPECT_THROW((void)deserialize<compact_delta>(reader), std::out_of_range);
+	}
+
+	struct temporary_log_file
+	{
+		std::filesystem::path path;
+
+		explicit temporary_log_file(std::string_view suffix = {})
+			: path(std::filesystem::temp_directory_path() /
+				std::format("fox_serialize_{}{}.log", ::testing::UnitTest::GetInstance()->current_test_info()->name(), suffix))
+		{
+			std::filesystem::remove(path);
+		}
+
+		~temporary_log_file() { std::filesystem::remove(path); }
+	};
+
+	TEST(serialize_record_log, seek_and_iterate)
+	{
+		temporary_log_file log;
+		const record_log_options options{ .index_interval = 100, .index_stride = 8, .batch_size = 512 };
+
+		{
+			record_log_writer writer(log.path, options);
+			for (std::uint64_t i = 0; i < 1000; ++i)
+				EXPECT_EQ(writer.append(i, std::format("event-{}", i)), i);
+			writer.sync();
+			EXPECT_EQ(writer.size(), 1000u);
+			EXPECT_EQ(writer.size_bytes(), std::filesystem::file_size(log.path));
+		}
+
+		const mapped_file file(log.path);
+		const record_log_reader reader(file.bytes());
+		ASSERT_EQ(reader.size(), 1000u);
+
+		std::uint64_t expected = 0;
+		for (const log_record& record : reader)
+		{
+			bit_reader payload(std::from_range, record.payload);
+			EXPECT_EQ(record.number, expected);
+			EXPECT_EQ(deserialize<std::uint64_t>(payload), expected);
+			++expected;
+		}
+		EXPECT_EQ(expected, 1000u);
+
+		for (const std::uint64_t n : { 0, 1, 7, 8, 99, 100, 101, 555, 899, 900, 950, 999 })
+		{
+			auto it = reader.seek(n);
+			ASSERT_NE(it, std::default_sentinel);
+			EXPECT_EQ(it->number, n);
+
+			bit_reader payload(std::from_range, it->payload);
+			EXPECT_EQ((deserialize<std::pair<std::uint64_t, std::string>>(payload)), (std::pair{ n, std::format("event-{}", n) }));
+		}
+		EXPECT_EQ(reader.seek(1000), std::default_sentinel);
+	}
+
+	TEST(serialize_record_log, move_assignment_flushes)
+	{
+		temporary_log_file first_log("_first");
+		temporary_log_file second_log("_second");
+
+		record_log_writer writer(first_log.path);
+		(void)writer.append(std::string("Fox"));
+		record_log_writer other(second_log.path);
+		(void)other.append(std::string("Capybara"));
+		(void)other.append(std::string("Axolotl"));
+
+		// Batched record of the replaced writer reaches its file
+		writer = std::move(other);
+		EXPECT_EQ(writer.size(), 2u);
+		{
+			const mapped_file file(first_log.path);
+			const record_log_reader reader(file.bytes());
+			ASSERT_EQ(reader.size(), 1u);
+			bit_reader payload(std::from_range, reader.begin()->payload);
+			EXPECT_EQ(deserialize<std::string>(payload), "Fox");
+		}
+
+		EXPECT_EQ(writer.append(std::string("Quokka")), 2u);
+		writer.sync();
+		const mapped_file file(second_log.path);
+		const record_log_reader reader(file.bytes());
+		EXPECT_EQ(reader.size(), 3u);
+	}
+
+	TEST(serialize_record_log, reopen_after_torn_write)
+	{
+		temporary_log_file log;
+		const record_log_options options{ .index_interval = 16, .index_stride = 4 };
+
+		{
+			record_log_writer writer(log.path, options);
+			for (int i = 0; i < 40; ++i)
+				(void)writer.append(i);
+		}
+
+		// Partially written record
+		{
+			std::ofstream file(log.path, std::ios::binary | std::ios::app);
+			file.write("\x20\x00\x01", 3);
+		}
+
+		{
+			const mapped_file file(log.path);
+			const record_log_reader reader(file.bytes());
+			EXPECT_EQ(reader.size(), 40u);
+			EXPECT_EQ(reader.valid_size(), std::size(file.bytes()) - 3);
+		}
+
+		{
+			record_log_writer writer(log.path, options);
+			EXPECT_EQ(writer.size(), 40u);
+			for (int i = 40; i < 70; ++i)
+				EXPECT_EQ(writer.append(i), static_cast<std::uint64_t>(i));
+		}
+
+		const mapped_file file(log.path);
+		const record_log_reader reader(file.bytes());
+		ASSERT_EQ(reader.size(), 70u);
+		for (int n = 0; n < 70; ++n)
+		{
+			bit_reader payload(std::from_range, reader.seek(static_cast<std::uint64_t>(n))->payload);
+			EXPECT_EQ(deserialize<int>(payload), n);
+		}
+
+		EXPECT_THROW(record_log_reader(std::as_bytes(std::span("not a log"))), std::invalid_argument);
+
+		// Bytes changed after the log was opened
+		std::vector<std::byte> bytes(std::begin(file.bytes()), std::end(file.bytes()));
+		const record_log_reader changed(bytes);
+		const std::size_t first = changed.begin().offset();
+		std::fill_n(std::begin(bytes) + static_cast<std::ptrdiff_t>(first), 3, std::byte{ 0xFF });
+		bytes[first + 3] = std::byte{ 0x7F };
+		EXPECT_THROW((void)changed.begin(), std::invalid_argument);
+	}
+
+	TEST(serialize_page_storage, grows_in_place)
+	{
+		page_storage storage;
+		external_bit_writer writer(storage);
+
+		std::vector<std::uint32_t> a(1 << 20);
+		std::iota(std::begin(a), std::end(a), 0u);
+
+		const std::size_t length = writer.write_placeholder(sizeof(std::uint32_t));
+		for (int i = 0; i < 8; ++i)
+			writer | a;
+		writer.patch(length, std::uint32_t{ 8 });
+
+		EXPECT_GE(storage.capacity(), std::size(writer.data()));
+		EXPECT_EQ(std::data(writer.data()), std::data(storage.storage()));
+
+		bit_reader reader(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<std::uint32_t>(reader), 8u);
+		for (int i = 0; i < 8; ++i)
+			EXPECT_EQ(deserialize<std::vector<std::uint32_t>>(reader), a);
+
+		// Capacity is kept after clear
+		const std::size_t capacity = storage.capacity();
+		writer.clear();
+		EXPECT_TRUE(std::empty(writer.data()));
+		EXPECT_EQ(storage.capacity(), capacity);
+
+		writer | std::string("Axolotl");
+		bit_reader cleared(std::from_range, writer.data());
+		EXPECT_EQ(deserialize<std::string>(cleared), "Axolotl");
+
+		writer.reserve(capacity * 2);
+		EXPECT_GE(storage.capacity(), capacity * 2);
+		EXPECT_EQ(writer.capacity(), storage.capacity());
+
+		// A copy would keep pointing at the pages after they're remapped
+		static_assert(!std::is_copy_constructible_v<decltype(writer)>);
+		external_bit_writer moved(std::move(writer));
+		moved | a;
+		EXPECT_EQ(std::data(moved.data()), std::data(storage.storage()));
+		EXPECT_EQ(moved.capacity(), storage.capacity());
+	}
+
+	TEST(serialize_concurrent_append, producers_and_consumer)
+	{
+		constexpr int producers = 4;
+		constexpr int records = 2000;
+
+		// Much smaller than all records, producers wait for the consumer when it's full
+		concurrent_append_buffer buffer(1000);
+
+		std::vector<std::thread> threads;
+		for (int p = 0; p < producers; ++p)
+		{
+			threads.emplace_back([&buffer, p]
+			{
+				for (int i = 0; i < records; ++i)
+				{
+					const std::string str(static_cast<std::size_t>(i % 7), 'x');
+					while (i % 2 == 0 ? !buffer.append(p, i, str) : !buffer.append_bounded(64, p, i, str))
+						std::this_thread::yield();
+				}
+			});
+		}
+
+		// Drained concurrently with the producers, records of every producer arrive in order
+		std::array<int, producers> next{};
+		std::size_t drained = 0;
+		while (drained < producers * records)
+		{
+			const std::size_t count = buffer.drain([&](std::span<const std::byte> payload)
+			{
+				bit_reader reader(std::from_range, payload);
+				const auto [p, i, str] = deserialize<std::tuple<int, int, std::string>>(reader);
+				EXPECT_EQ(i, next[static_cast<std::size_t>(p)]++);
+				EXPECT_EQ(str, std::string(static_cast<std::size_t>(i % 7), 'x'));
+				EXPECT_EQ(reader.remaining(), 0u);
+			});
+
+			drained += count;
+			if (count == 0)
+				std::this_thread::yield();
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		EXPECT_EQ(buffer.drain([](std::span<const std::byte>) {}), 0u);
+		for (const int n : next)
+			EXPECT_EQ(n, records);
+	}
+
+	TEST(serialize_concurrent_append, overflow)
+	{
+		concurrent_append_buffer buffer(64);
+		const auto values = [&]
+		{
+			std::vector<std::uint32_t> out;
+			(void)buffer.drain([&](std::span<const std::byte> payload)
+			{
+				bit_reader reader(std::from_range, payload);
+				out.push_back(deserialize<std::uint32_t>(reader));
+			});
+			return out;
+		};
+
+		// Too small bound, the record is skipped
+		EXPECT_THROW((void)buffer.append_bounded(2, std::uint64_t{ 1 }), buffer_overflow);
+		EXPECT_TRUE(buffer.append(std::uint32_t{ 7 }));
+		EXPECT_THROW((void)buffer.append(std::array<std::uint64_t, 8>{}), buffer_overflow);
+		EXPECT_EQ(values(), std::vector<std::uint32_t>{ 7 });
+		EXPECT_EQ(buffer.reserved(), 0u);
+
+		// Full buffer reports backpressure, drained space is reused and records wrap around to the beginning
+		EXPECT_TRUE(buffer.append_bytes(std::vector<std::byte>(16)));
+		EXPECT_TRUE(buffer.append(std::uint32_t{ 8 }));
+		EXPECT_FALSE(buffer.append(std::uint32_t{ 9 }));
+		EXPECT_EQ(values(), std::vector<std::uint32_t>({ 0, 8 }));
+		EXPECT_TRUE(buffer.append(std::uint32_t{ 9 }));
+		EXPECT_EQ(values(), std::vector<std::uint32_t>{ 9 });
+
+		// Record doesn't fit before the end of the buffer, it's reserved at the beginning once the end is drained
+		EXPECT_FALSE(buffer.append_bytes(std::vector<std::byte>(32)));
+		EXPECT_EQ(buffer.drain([](std::span<const std::byte>) {}), 0u);
+		EXPECT_TRUE(buffer.append_bytes(std::vector<std::byte>(32)));
+		EXPECT_EQ(buffer.drain([](std::span<const std::byte> payload) { EXPECT_EQ(std::size(payload), 32u); }), 1u);
+
+		// Record is drained again if the consumer throws
+		EXPECT_TRUE(buffer.append(std::uint32_t{ 10 }));
+		EXPECT_THROW((void)buffer.drain([](std::span<const std::byte>) { throw std::runtime_error("Consumer failed"); }), std::runtime_error);
+		EXPECT_EQ(values(), std::vector<std::uint32_t>{ 10 });
+
+		// Reset discards the records
+		EXPECT_TRUE(buffer.append(std::uint32_t{ 11 }));
+		buffer.reset();
+		EXPECT_EQ(buffer.reserved(), 0u);
+		EXPECT_TRUE(buffer.append_bytes(std::vector<std::byte>(48)));
+		EXPECT_FALSE(buffer.append_bytes(std::vector<std::byte>(1)));
+		EXPECT_EQ(buffer.drain([](std::span<const std::byte> payload) { EXPECT_EQ(std::size(payload), 48u); }), 1u);
+	}
+
+	TEST(serialize_serialized_size, matches_every_builtin_trait)
+	{
+		const auto check = [](const auto& value)
+		{
+			bit_writer writer;
+			writer | value;
+			EXPECT_EQ(serialized_size(value), writer.size()) << typeid(value).name();
+		};
+
+		check(7);
+		check(1.5);
+		check(wide_color{});
+		check(compact_color::blue);
+		check(std::bitset<200>().set(150));
+		check(std::vector<bool>(130, true));
+		check(std::vector<int>{ 1, 2, 3 });
+		check(std::deque<std::int64_t>(600, 5));
+		check(std::list<std::string>{ "Fox", "Capybara" });
+		check(std::forward_list<std::string>{ "Fox", "Capybara" });
+		check(std::forward_list<int>{ 1, 2 });
+		check(std::map<std::string, std::vector<int>>{ { "Fox", { 1 } }, { "Capybara", {} } });
+		check(std::set<int>{ 1, 2, 3 });
+		check(std::array<std::string, 2>{ "Fox", "Capybara" });
+		check(std::string("Foxes"));
+		check(std::string_view("Foxes"));
+		check(std::optional<int>());
+		check(std::optional<std::string>("Foxes"));
+		check(std::variant<int, std::string>(std::in_place_index<1>, "Foxes"));
+		check(std::variant<int, std::string>(3));
+		check(std::tuple<int, std::string, std::optional<double>>(1, "Fox", 2.0));
+		check(std::pair<const std::string, char>("Fox", 'c'));
+		check(std::make_unique<std::string>("Foxes"));
+		check(std::unique_ptr<int>());
+		check(std::make_shared<std::vector<int>>(3, 1));
+		check(md_array<std::string, 2>({ 2, 2 }, "Fox"));
+		check(md_array<float, 3>(2, 3, 4));
+		check(test_trait<udt_serialize_from_members<0>>::construct());
+#ifdef FOX_SERIALIZE_HAS_REFLEXPR
+		check(test_trait<udt_aggregate_type>::construct());
+#endif
+	}
+}